@@ -11,12 +11,69 @@
  */
 #include "DFRobot_ENS160.h"
 
+/* States of the command at the head of the queue */
+#define CMD_STATE_NONE    0   // Not started
+#define CMD_STATE_ISSUE   1   // In IDLE mode, COMMAND to be written
+#define CMD_STATE_WAIT    2   // Waiting for NEWGPR
+
 DFRobot_ENS160::DFRobot_ENS160()
 {
+  memset(&ENS160Status, 0, sizeof(ENS160Status));
   misr = 0;   // Mirror of DATA_MISR (0 is hardware default)
+  misrCheck = false;
+  misrStats.checked = 0;
+  misrStats.mismatch = 0;
+  opModePending = false;
+  configPending = false;
+  switching = false;
+  switchStart = 0;
+  heaterStart = 0;
+  cmdHead = 0;
+  cmdCount = 0;
+  cmdState = CMD_STATE_NONE;
+  gprReady = false;
+  sampleCallback = NULL;
+  sampleArg = NULL;
+  memset(&lastSnapshot, 0, sizeof(lastSnapshot));
+  selfHealing = false;
+  recovering = false;
+  healErrors = 0;
+  healOPMode = ENS160_STANDARD_MODE;
+  healConfig = 0;
+  healComp = false;
+  healCheck = 0;
+  healTime = 0;
+  healBackoff = 0;
+  memset(&healStats, 0, sizeof(healStats));
+  cachedOPMode = ENS160_SLEEP_MODE;   // Hardware defaults, only valid with their cache flags
+  cachedConfig = 0;
+  cachedTempIn = 0;
+  cachedRHIn = 0;
+  invalidateCache();
+  compTempThreshold = ENS160_COMP_TEMP_THRESHOLD;
+  compHumThreshold = ENS160_COMP_HUM_THRESHOLD;
+  compMaxAge = ENS160_COMP_MAX_AGE;
+  compTemp = 0;
+  compHum = 0;
+  compTime = 0;
+#ifdef ENABLE_BUS_STATS
+  resetBusStats();
+#endif
 }
 
 int DFRobot_ENS160::begin(void)
+{
+  int ret = DFRobot_ENS160::beginAsync();
+  if(NO_ERR == ret) {
+    while(!poll()) {
+      yield();
+    }
+    DBG("begin ok!");
+  }
+  return ret;
+}
+
+int DFRobot_ENS160::beginAsync(void)
 {
   uint8_t idBuf[2];
   if(0 == readReg(ENS160_PART_ID_REG, idBuf, sizeof(idBuf)))   // Judge whether the data bus is successful
@@ -25,16 +82,21 @@ int DFRobot_ENS160::begin(void)
     return ERR_DATA_BUS;
   }
 
+  invalidateCache();   // The state of the sensor is unknown, write the default config unconditionally
+  cmdCount = 0;
+  cmdState = CMD_STATE_NONE;
+  recovering = false;
+  healErrors = 0;
+
   DBG("real sensor id=");DBG(ENS160_CONCAT_BYTES(idBuf[1], idBuf[0]));
   if(ENS160_PART_ID != ENS160_CONCAT_BYTES(idBuf[1], idBuf[0]))   // Judge whether the chip version matches
   {
     DBG("ERR_IC_VERSION");
     return ERR_IC_VERSION;
   }
-  setPWRMode(ENS160_STANDARD_MODE);
-  setINTMode(0x00);
+  setPWRModeAsync(ENS160_STANDARD_MODE);
+  setINTModeAsync(0x00);
 
-  DBG("begin ok!");
   return NO_ERR;
 }
 
@@ -42,58 +104,786 @@ int DFRobot_ENS160::begin(void)
 
 void DFRobot_ENS160::setPWRMode(uint8_t mode)
 {
-  writeReg(ENS160_OPMODE_REG, &mode, sizeof(mode));
-  delay(20);   // Give it some time to switch mode
+  setPWRModeAsync(mode);
+  while(!pollSwitch()) {   // Give it some time to switch mode, queued commands are left to poll()
+    yield();
+  }
 }
 
 void DFRobot_ENS160::setINTMode(uint8_t mode)
 {
-  mode |= (eINTDataDrdyEN | eIntGprDrdyDIS);
-  writeReg(ENS160_CONFIG_REG, &mode, sizeof(mode));
-  delay(20);   // Give it some time to switch mode
+  setINTModeAsync(mode);
+  while(!pollSwitch()) {
+    yield();
+  }
+}
+
+void DFRobot_ENS160::setPWRModeAsync(uint8_t mode)
+{
+  if(CMD_STATE_NONE != cmdState) {
+    cmdRestoreMode = mode;   // Commands run in IDLE mode, switch to this mode afterwards
+    return;
+  }
+  if((cacheFlags & ENS160_CACHE_OPMODE) && (cachedOPMode == mode)) {
+    opModePending = false;   // Already in this mode, nothing to write or wait for
+    return;
+  }
+  pendingOPMode = mode;
+  opModePending = true;
+  poll();   // Issue the write at once if the sensor is not switching
+}
+
+void DFRobot_ENS160::setINTModeAsync(uint8_t mode)
+{
+  if(0 == (mode & eIntGprDrdyEN)) {
+    mode |= eINTDataDrdyEN;   // Interrupt on new data in DATA_XXX unless GPR data ready is selected
+  }
+  if((cacheFlags & ENS160_CACHE_CONFIG) && (cachedConfig == mode)) {
+    configPending = false;
+    return;
+  }
+  pendingConfig = mode;
+  configPending = true;
+  poll();
+}
+
+bool DFRobot_ENS160::poll(void)
+{
+  if(!pollSwitch()) {
+    return false;
+  }
+  return pollCommand();
+}
+
+bool DFRobot_ENS160::pollSwitch(void)
+{
+  if(switching) {
+    if((uint32_t)(millis() - switchStart) < ENS160_SWITCH_TIME) {
+      return false;
+    }
+    switching = false;
+  }
+
+  if(opModePending) {
+    opModePending = false;
+    if((ENS160_STANDARD_MODE == pendingOPMode) && (getHeaterOnTime() == 0)) {
+      heaterStart = millis();   // Warm-up starts over
+    }
+    writeReg(ENS160_OPMODE_REG, &pendingOPMode, sizeof(pendingOPMode));
+    cachedOPMode = pendingOPMode;
+    cacheFlags |= ENS160_CACHE_OPMODE;
+  } else if(configPending) {
+    configPending = false;
+    writeReg(ENS160_CONFIG_REG, &pendingConfig, sizeof(pendingConfig));
+    cachedConfig = pendingConfig;
+    cacheFlags |= ENS160_CACHE_CONFIG;
+  } else {
+    return true;
+  }
+  switching = true;
+  switchStart = millis();
+  return false;
+}
+
+bool DFRobot_ENS160::isReady(void)
+{
+  if(opModePending || configPending || cmdCount) {
+    return false;
+  }
+  return !switching || ((uint32_t)(millis() - switchStart) >= ENS160_SWITCH_TIME);
 }
 
 void DFRobot_ENS160::setTempAndHum(float ambientTemp, float relativeHumidity)
 {
+  // Clamp to the operating range, out-of-range values would wrap in the uint16_t registers
+  ambientTemp = constrain(ambientTemp, -40.0, 85.0);
+  relativeHumidity = constrain(relativeHumidity, 0.0, 100.0);
   uint16_t temp = (ambientTemp + 273.15) * 64;
   uint16_t rh = relativeHumidity * 512;
+  writeTempAndHum(temp, rh);
+}
+
+void DFRobot_ENS160::setTempAndHumFixed(int16_t ambientTemp, uint16_t relativeHumidity)
+{
+  uint16_t temp, rh;
+  encodeTempAndHum(ambientTemp, relativeHumidity, &temp, &rh);
+  writeTempAndHum(temp, rh);
+}
+
+void DFRobot_ENS160::setCompensationPolicy(uint16_t tempThreshold, uint16_t humThreshold, uint32_t maxAge)
+{
+  compTempThreshold = tempThreshold;
+  compHumThreshold = humThreshold;
+  compMaxAge = maxAge;
+}
+
+bool DFRobot_ENS160::updateTempAndHum(int16_t ambientTemp, uint16_t relativeHumidity)
+{
+  uint32_t now = millis();
+  bool expired = (uint32_t)(now - compTime) >= compMaxAge;
+  if((cacheFlags & ENS160_CACHE_TEMP_HUM) && !expired &&
+     (abs((int32_t)ambientTemp - compTemp) < compTempThreshold) &&
+     (abs((int32_t)relativeHumidity - compHum) < compHumThreshold)) {
+    return false;
+  }
+
+  if(expired) {
+    cacheFlags &= ~ENS160_CACHE_TEMP_HUM;   // Write again even if unchanged, the sensor may have been reset
+  }
+  setTempAndHumFixed(ambientTemp, relativeHumidity);
+  compTemp = ambientTemp;
+  compHum = relativeHumidity;
+  compTime = now;
+  return true;
+}
+
+void DFRobot_ENS160::writeTempAndHum(uint16_t temp, uint16_t rh)
+{
   uint8_t buf[4];
 
+  if((cacheFlags & ENS160_CACHE_TEMP_HUM) && (cachedTempIn == temp) && (cachedRHIn == rh)) {
+    return;
+  }
+
   buf[0] = temp & 0xFF;
   buf[1] = (temp & 0xFF00) >> 8;
   buf[2] = rh & 0xFF;
   buf[3] = (rh & 0xFF00) >> 8;
   writeReg(ENS160_TEMP_IN_REG, buf, sizeof(buf));
+  cachedTempIn = temp;
+  cachedRHIn = rh;
+  cacheFlags |= ENS160_CACHE_TEMP_HUM;
+}
+
+/***************** Shadow register cache ******************************/
+
+uint8_t DFRobot_ENS160::getCachedPWRMode(void)
+{
+  return cachedOPMode;
+}
+
+uint8_t DFRobot_ENS160::getCachedINTMode(void)
+{
+  return cachedConfig;
+}
+
+DFRobot_ENS160::sSensorStatus_t DFRobot_ENS160::getCachedStatus(void)
+{
+  return ENS160Status;
+}
+
+uint8_t DFRobot_ENS160::getCacheFlags(void)
+{
+  return cacheFlags;
+}
+
+void DFRobot_ENS160::invalidateCache(void)
+{
+  cacheFlags = 0;
+}
+
+int DFRobot_ENS160::resyncCache(void)
+{
+  uint8_t buf[4];
+  invalidateCache();
+
+  if(2 != readReg(ENS160_OPMODE_REG, buf, 2)) {   // OPMODE and CONFIG
+    DBG("ERR_DATA_BUS");
+    return ERR_DATA_BUS;
+  }
+  cachedOPMode = buf[0];
+  cachedConfig = buf[1];
+  cacheFlags |= (ENS160_CACHE_OPMODE | ENS160_CACHE_CONFIG);
+
+  if(sizeof(buf) != readReg(ENS160_TEMP_IN_REG, buf, sizeof(buf))) {   // TEMP_IN and RH_IN
+    DBG("ERR_DATA_BUS");
+    return ERR_DATA_BUS;
+  }
+  cachedTempIn = ENS160_CONCAT_BYTES(buf[1], buf[0]);
+  cachedRHIn = ENS160_CONCAT_BYTES(buf[3], buf[2]);
+  cacheFlags |= ENS160_CACHE_TEMP_HUM;
+
+  getENS160Status();
+  return (cacheFlags & ENS160_CACHE_STATUS) ? NO_ERR : ERR_DATA_BUS;
+}
+
+/***************** Warm start ******************************/
+
+void DFRobot_ENS160::getWarmState(sWarmState_t *state)
+{
+  if(NULL == state) {
+    DBG("state ERROR!! : null pointer");
+    return;
+  }
+  memset(state, 0, sizeof(sWarmState_t));
+  if((ENS160_CACHE_OPMODE | ENS160_CACHE_CONFIG) != (cacheFlags & (ENS160_CACHE_OPMODE | ENS160_CACHE_CONFIG))) {
+    return;   // Nothing verified to save
+  }
+  state->magic = ENS160_WARM_MAGIC;
+  state->partID = ENS160_PART_ID;
+  state->opMode = cachedOPMode;
+  state->config = cachedConfig;
+  state->validity = (cacheFlags & ENS160_CACHE_STATUS) ? ENS160Status.validityFlag : (uint8_t)eInvalidOutput;
+  if(cacheFlags & ENS160_CACHE_TEMP_HUM) {
+    state->compValid = 1;
+    state->tempIn = cachedTempIn;
+    state->rhIn = cachedRHIn;
+  }
+  state->heaterOnTime = getHeaterOnTime();
+  state->checksum = warmChecksum(state);
+}
+
+int DFRobot_ENS160::beginWarm(const sWarmState_t *state, uint32_t offTime)
+{
+  uint8_t buf[4];
+
+  if((NULL == state) || (ENS160_WARM_MAGIC != state->magic) || (ENS160_PART_ID != state->partID) ||
+     (warmChecksum(state) != state->checksum)) {
+    DBG("no valid warm state");
+    return DFRobot_ENS160::begin();
+  }
+
+  if(2 != readReg(ENS160_PART_ID_REG, buf, 2)) {
+    DBG("ERR_DATA_BUS");
+    return ERR_DATA_BUS;
+  }
+  if(ENS160_PART_ID != ENS160_CONCAT_BYTES(buf[1], buf[0])) {   // E.g. another device at this address
+    DBG("ERR_IC_VERSION");
+    return ERR_IC_VERSION;
+  }
+  if(2 != readReg(ENS160_OPMODE_REG, buf, 2)) {   // OPMODE and CONFIG
+    DBG("ERR_DATA_BUS");
+    return ERR_DATA_BUS;
+  }
+  if((buf[0] != state->opMode) || (buf[1] != state->config)) {
+    DBG("sensor state changed, cold start");   // E.g. the sensor was power cycled as well
+    return DFRobot_ENS160::begin();
+  }
+  // The phases only move forward (Initial Start-Up, Warm-Up, Normal) while the sensor stays powered
+  bool statusValid = (ENS160_STANDARD_MODE == state->opMode) && (eInvalidOutput != state->validity);
+  if(statusValid) {
+    if(1 != readReg(ENS160_DATA_STATUS_REG, buf, 1)) {
+      DBG("ERR_DATA_BUS");
+      return ERR_DATA_BUS;
+    }
+    memcpy(&ENS160Status, &buf[0], sizeof(ENS160Status));
+    if(ENS160Status.validityFlag > state->validity) {
+      DBG("sensor phase went back, cold start");   // E.g. reset and set up again by another host
+      return DFRobot_ENS160::begin();
+    }
+  }
+
+  invalidateCache();
+  cmdCount = 0;
+  cmdState = CMD_STATE_NONE;
+  healErrors = 0;
+  opModePending = false;
+  configPending = false;
+  switching = false;
+  recovering = false;
+  cachedOPMode = state->opMode;
+  cachedConfig = state->config;
+  cacheFlags |= (ENS160_CACHE_OPMODE | ENS160_CACHE_CONFIG);
+  if(statusValid) {
+    cacheFlags |= ENS160_CACHE_STATUS;
+  }
+  if(ENS160_STANDARD_MODE == cachedOPMode) {
+    heaterStart = millis() - (state->heaterOnTime + offTime);
+  }
+
+  // Compensation is only trusted if the sensor still holds it
+  if(state->compValid && (sizeof(buf) == readReg(ENS160_TEMP_IN_REG, buf, sizeof(buf))) &&
+     (ENS160_CONCAT_BYTES(buf[1], buf[0]) == state->tempIn) && (ENS160_CONCAT_BYTES(buf[3], buf[2]) == state->rhIn)) {
+    cachedTempIn = state->tempIn;
+    cachedRHIn = state->rhIn;
+    cacheFlags |= ENS160_CACHE_TEMP_HUM;
+  }
+
+  if(misrCheck) {
+    misr = getMISR();   // The sensor kept counting while the MCU was reset
+  }
+  DBG("warm start ok!");
+  return NO_ERR;
+}
+
+uint32_t DFRobot_ENS160::getHeaterOnTime(void)
+{
+  if((cacheFlags & ENS160_CACHE_OPMODE) && (ENS160_STANDARD_MODE == cachedOPMode)) {
+    return millis() - heaterStart;
+  }
+  return 0;
+}
+
+/***************** Command pipeline ******************************/
+
+bool DFRobot_ENS160::queueCommand(uint8_t command, commandCallback_t callback)
+{
+  if(ENS160_CMD_QUEUE_SIZE <= cmdCount) {
+    DBG("command queue full");
+    return false;
+  }
+  uint8_t tail = (cmdHead + cmdCount) % ENS160_CMD_QUEUE_SIZE;
+  cmdQueue[tail] = command;
+  cmdCallback[tail] = callback;
+  cmdCount++;
+  if((CMD_STATE_NONE == cmdState) && opModePending) {
+    // The mode write waits for a switch, e.g. the switch back after the last command:
+    // go to IDLE instead and to that mode after the commands, so they share one IDLE phase
+    cmdRestoreMode = pendingOPMode;
+    pendingOPMode = ENS160_IDLE_MODE;
+    opModePending = !((cacheFlags & ENS160_CACHE_OPMODE) && (ENS160_IDLE_MODE == cachedOPMode));
+    cmdState = CMD_STATE_ISSUE;
+  }
+  return true;
+}
+
+uint8_t DFRobot_ENS160::getCommandCount(void)
+{
+  return cmdCount;
+}
+
+void DFRobot_ENS160::onGPRReady(void)
+{
+  gprReady = true;
+}
+
+void DFRobot_ENS160::decodeAppVersion(const uint8_t *gpr, sAppVersion_t *version)
+{
+  version->major = gpr[4];
+  version->minor = gpr[5];
+  version->release = gpr[6];
+}
+
+bool DFRobot_ENS160::pollCommand(void)
+{
+  uint8_t gpr[8];
+  int result = NO_ERR;
+
+  if(0 == cmdCount) {
+    return true;
+  }
+  memset(gpr, 0, sizeof(gpr));
+
+  switch(cmdState) {
+  case CMD_STATE_NONE:
+    cmdRestoreMode = (cacheFlags & ENS160_CACHE_OPMODE) ? cachedOPMode : ENS160_STANDARD_MODE;
+    cmdState = CMD_STATE_ISSUE;
+    if(!(cacheFlags & ENS160_CACHE_OPMODE) || (ENS160_IDLE_MODE != cachedOPMode)) {
+      pendingOPMode = ENS160_IDLE_MODE;   // Written by the next poll()
+      opModePending = true;
+      return false;
+    }
+    // fall through
+  case CMD_STATE_ISSUE:
+    if(ENS160_COMMAND_GET_APPVER != cmdQueue[cmdHead]) {   // Only GET_APPVER answers in GPR_READ
+      writeReg(ENS160_COMMAND_REG, &cmdQueue[cmdHead], 1);
+      break;
+    }
+    readReg(ENS160_GPR_READ_REG, gpr, sizeof(gpr));   // Clears NEWGPR left over from the measurement
+    gprReady = false;
+    writeReg(ENS160_COMMAND_REG, &cmdQueue[cmdHead], 1);
+    cmdStart = millis();
+    cmdCheck = cmdStart;
+    cmdState = CMD_STATE_WAIT;
+    return false;
+  default:
+    if(!gprReady) {
+      uint32_t now = millis();
+      if((uint32_t)(now - cmdCheck) < ENS160_CMD_POLL_TIME) {
+        return false;
+      }
+      cmdCheck = now;
+      getENS160Status();
+      if(!((cacheFlags & ENS160_CACHE_STATUS) && ENS160Status.GPRDrdy)) {
+        if((uint32_t)(now - cmdStart) < ENS160_CMD_TIMEOUT) {
+          return false;
+        }
+        DBG("ERR_CMD_TIMEOUT");
+        result = ERR_CMD_TIMEOUT;
+      }
+    }
+    if((NO_ERR == result) && (sizeof(gpr) != readReg(ENS160_GPR_READ_REG, gpr, sizeof(gpr)))) {
+      memset(gpr, 0, sizeof(gpr));
+      result = ERR_DATA_BUS;
+    }
+    break;
+  }
+
+  uint8_t command = cmdQueue[cmdHead];
+  commandCallback_t callback = cmdCallback[cmdHead];
+  cmdHead = (cmdHead + 1) % ENS160_CMD_QUEUE_SIZE;
+  cmdCount--;
+  if(cmdCount) {
+    cmdState = CMD_STATE_ISSUE;   // Next command in the same IDLE phase
+  } else {
+    cmdState = CMD_STATE_NONE;
+    if(ENS160_IDLE_MODE != cmdRestoreMode) {
+      pendingOPMode = cmdRestoreMode;
+      opModePending = true;
+    }
+  }
+  if(NULL != callback) {
+    callback(command, result, gpr);
+  }
+  return false;
+}
+
+uint8_t DFRobot_ENS160::warmChecksum(const sWarmState_t *state)
+{
+  const uint8_t *p = (const uint8_t *)state;
+  uint8_t crc = 0;
+  for(size_t i = 0; i < offsetof(sWarmState_t, checksum); i++) {
+    crc ^= p[i];
+    for(uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? ((crc << 1) ^ POLY) : (crc << 1);
+    }
+  }
+  return crc;
 }
 
 /***************** Performance function ******************************/
 uint8_t DFRobot_ENS160::getENS160Status(void)
 {
-  readReg(ENS160_DATA_STATUS_REG, &ENS160Status, sizeof(ENS160Status));
+  if(sizeof(ENS160Status) == readDataReg(ENS160_DATA_STATUS_REG, &ENS160Status, sizeof(ENS160Status))) {
+    cacheFlags |= ENS160_CACHE_STATUS;
+  }
   return ENS160Status.validityFlag;
 }
 
 uint8_t DFRobot_ENS160::getAQI(void)
 {
   uint8_t data = 0;
-  readReg(ENS160_DATA_AQI_REG, &data, sizeof(data));
+  readDataReg(ENS160_DATA_AQI_REG, &data, sizeof(data));
   return data;
 }
 
 uint16_t DFRobot_ENS160::getTVOC(void)
 {
-  uint8_t buf[2];
-  readReg(ENS160_DATA_TVOC_REG, buf, sizeof(buf));
+  uint8_t buf[2] = {0, 0};   // A short read must not return stack garbage
+  readDataReg(ENS160_DATA_TVOC_REG, buf, sizeof(buf));
   return ENS160_CONCAT_BYTES(buf[1], buf[0]);
 }
 
 uint16_t DFRobot_ENS160::getECO2(void)
 {
-  uint8_t buf[2];
-  readReg(ENS160_DATA_ECO2_REG, buf, sizeof(buf));
+  uint8_t buf[2] = {0, 0};
+  readDataReg(ENS160_DATA_ECO2_REG, buf, sizeof(buf));
   return ENS160_CONCAT_BYTES(buf[1], buf[0]);
 }
 
+int DFRobot_ENS160::readSnapshot(sSnapshot_t *snapshot)
+{
+  uint8_t buf[6] = {0};   // DATA_STATUS, DATA_AQI, DATA_TVOC(2), DATA_ECO2(2)
+  int ret = NO_ERR;
+  if(NULL == snapshot) {
+    DBG("snapshot ERROR!! : null pointer");
+    return ERR_DATA_BUS;
+  }
+  if(recovering) {
+    ret = tryRecover();
+  } else if(selfHealing && (opModePending || configPending)) {
+    poll();   // Finish restoring the configuration, applications may never call poll() themselves
+  }
+  if((NO_ERR == ret) && (sizeof(buf) != readDataReg(ENS160_DATA_STATUS_REG, buf, sizeof(buf)))) {
+    DBG("ERR_DATA_BUS");
+    ret = healFault(ERR_DATA_BUS);
+  } else if(NO_ERR == ret) {
+    memcpy(&ENS160Status, &buf[0], sizeof(ENS160Status));
+    cacheFlags |= ENS160_CACHE_STATUS;
+    snapshot->status = ENS160Status;
+    snapshot->AQI = buf[1];
+    snapshot->TVOC = ENS160_CONCAT_BYTES(buf[3], buf[2]);
+    snapshot->ECO2 = ENS160_CONCAT_BYTES(buf[5], buf[4]);
+
+    if(misrCheck) {
+      uint8_t crc = getMISR();   // Reading DATA_MISR does not change its value
+      misrStats.checked++;
+      if(crc != misr) {
+        DBG("ERR_MISR_CHECK");
+        misrStats.mismatch++;
+        misr = crc;   // Resynchronize so that the next sample can be verified
+        if(selfHealing && (NO_ERR != verifyConfig())) {   // DATA_MISR also starts over after a reset
+          ret = ERR_SENSOR_FAULT;
+        } else {
+          ret = healFault(ERR_MISR_CHECK);
+        }
+      }
+    }
+    if((NO_ERR == ret) && selfHealing) {
+      if(ENS160Status.stater) {
+        DBG("STATER");
+        startRecovery();
+        ret = ERR_SENSOR_FAULT;
+      } else if(((uint32_t)(millis() - healCheck) >= ENS160_HEAL_CHECK_TIME) ||
+                ((cacheFlags & ENS160_CACHE_OPMODE) && (ENS160_STANDARD_MODE == cachedOPMode) && !ENS160Status.status)) {
+        ret = verifyConfig();   // Periodically, or at once if STANDARD mode stopped running
+      }
+    }
+  }
+
+  if(NO_ERR != ret) {
+    if(recovering) {
+      tryRecover();   // Configure the sensor again now, so that the next sample is good
+    }
+    *snapshot = lastSnapshot;
+    snapshot->stale = 1;
+    healStats.staleSamples++;
+    return ret;
+  }
+  healErrors = 0;
+  snapshot->stale = 0;
+  lastSnapshot = *snapshot;
+  if(NULL != sampleCallback) {
+    sampleCallback(snapshot, sampleArg);
+  }
+  return NO_ERR;
+}
+
+void DFRobot_ENS160::setSampleCallback(sampleCallback_t callback, void *arg)
+{
+  sampleCallback = callback;
+  sampleArg = arg;
+}
+
+int DFRobot_ENS160::readGPR(sGPRData_t *gpr)
+{
+  uint8_t buf[8];   // GPR_READ0..GPR_READ7
+  if(NULL == gpr) {
+    DBG("gpr ERROR!! : null pointer");
+    return ERR_DATA_BUS;
+  }
+  if(sizeof(buf) != readReg(ENS160_GPR_READ_REG, buf, sizeof(buf))) {
+    DBG("ERR_DATA_BUS");
+    return ERR_DATA_BUS;
+  }
+
+  gpr->hp0Raw = ENS160_CONCAT_BYTES(buf[1], buf[0]);
+  gpr->hp1Raw = ENS160_CONCAT_BYTES(buf[3], buf[2]);
+  gpr->hp2Raw = ENS160_CONCAT_BYTES(buf[5], buf[4]);
+  gpr->hp3Raw = ENS160_CONCAT_BYTES(buf[7], buf[6]);
+  return NO_ERR;
+}
+
+float DFRobot_ENS160::rawToOhm(uint16_t raw)
+{
+  return pow(2, (float)raw / 2048);   // Raw value is log2 of the resistance, 11 fractional bits
+}
+
+/************************** Data integrity function ******************************/
+void DFRobot_ENS160::setMISRCheck(bool enable)
+{
+  if(enable) {
+    misr = getMISR();   // Start from the checksum the sensor currently holds
+  }
+  misrCheck = enable;
+}
+
+void DFRobot_ENS160::getMISRStats(sMISRStats_t *stats)
+{
+  if(NULL != stats) {
+    *stats = misrStats;
+  }
+}
+
+/************************** Self-healing function ******************************/
+void DFRobot_ENS160::setSelfHealing(bool enable)
+{
+  selfHealing = enable;
+  recovering = false;
+  healErrors = 0;
+  healCheck = millis();
+}
+
+int DFRobot_ENS160::checkHealth(void)
+{
+  int ret = NO_ERR;
+  if(!recovering) {
+    if(opModePending || configPending) {
+      poll();
+    }
+    cacheFlags &= ~ENS160_CACHE_STATUS;
+    getENS160Status();
+    if(!(cacheFlags & ENS160_CACHE_STATUS)) {
+      ret = healFault(ERR_DATA_BUS);
+    } else if(ENS160Status.stater) {
+      DBG("STATER");
+      startRecovery();
+    } else {
+      ret = verifyConfig();
+    }
+  }
+  return recovering ? tryRecover() : ret;
+}
+
+bool DFRobot_ENS160::isRecovering(void)
+{
+  return recovering;
+}
+
+void DFRobot_ENS160::getHealthStats(sHealthStats_t *stats)
+{
+  if(NULL != stats) {
+    *stats = healStats;
+  }
+}
+
+int DFRobot_ENS160::healFault(int err)
+{
+  if(selfHealing && (++healErrors >= ENS160_HEAL_ERRORS)) {
+    DBG("too many errors");
+    startRecovery();
+    return ERR_SENSOR_FAULT;
+  }
+  return err;
+}
+
+int DFRobot_ENS160::verifyConfig(void)
+{
+  uint8_t buf[2] = {0, 0};
+
+  healCheck = millis();
+  if(!isReady()) {
+    return NO_ERR;   // The registers are about to change anyway
+  }
+  if(sizeof(buf) != readReg(ENS160_OPMODE_REG, buf, sizeof(buf))) {   // OPMODE and CONFIG
+    DBG("ERR_DATA_BUS");
+    return healFault(ERR_DATA_BUS);
+  }
+  if(((cacheFlags & ENS160_CACHE_OPMODE) && (buf[0] != cachedOPMode)) ||
+     ((cacheFlags & ENS160_CACHE_CONFIG) && (buf[1] != cachedConfig))) {
+    DBG("sensor lost its configuration");
+    startRecovery();
+    return ERR_SENSOR_FAULT;
+  }
+  return NO_ERR;
+}
+
+void DFRobot_ENS160::startRecovery(void)
+{
+  if(recovering) {
+    return;
+  }
+  if(CMD_STATE_NONE != cmdState) {
+    healOPMode = cmdRestoreMode;   // The sensor is only in IDLE mode for the command
+  } else if(opModePending) {
+    healOPMode = pendingOPMode;
+  } else if(cacheFlags & ENS160_CACHE_OPMODE) {
+    healOPMode = cachedOPMode;
+  }
+  if(configPending) {
+    healConfig = pendingConfig;
+  } else if(cacheFlags & ENS160_CACHE_CONFIG) {
+    healConfig = cachedConfig;
+  }
+  healComp = (0 != (cacheFlags & ENS160_CACHE_TEMP_HUM));
+  invalidateCache();
+  recovering = true;
+  healBackoff = 0;   // First attempt at once
+  healTime = millis();
+  healStats.faults++;
+}
+
+int DFRobot_ENS160::tryRecover(void)
+{
+  uint8_t buf[4] = {0, 0, 0, 0};
+  uint32_t now = millis();
+
+  if((uint32_t)(now - healTime) < healBackoff) {
+    return ERR_SENSOR_FAULT;
+  }
+  healTime = now;
+  healStats.attempts++;
+  if((2 != readReg(ENS160_PART_ID_REG, buf, 2)) || (ENS160_PART_ID != ENS160_CONCAT_BYTES(buf[1], buf[0])) ||
+     (2 != readReg(ENS160_OPMODE_REG, &buf[2], 2))) {   // OPMODE and CONFIG
+    DBG("recovery failed");
+    if(0 == healBackoff) {
+      healBackoff = ENS160_HEAL_BACKOFF_MIN;
+    } else {
+      healBackoff = (healBackoff >= ENS160_HEAL_BACKOFF_MAX / 2) ? ENS160_HEAL_BACKOFF_MAX : (healBackoff * 2);
+    }
+    return ERR_SENSOR_FAULT;
+  }
+
+  // Compensation written while recovering is newer than the one before the fault
+  bool comp = healComp || (cacheFlags & ENS160_CACHE_TEMP_HUM);
+  uint16_t temp = cachedTempIn;
+  uint16_t rh = cachedRHIn;
+
+  // Start from what the sensor has kept and write only the registers that differ,
+  // rewriting OPMODE would restart the warm-up, e.g. after a few transient bus errors
+  cachedOPMode = buf[2];
+  cachedConfig = buf[3];
+  cacheFlags = ENS160_CACHE_OPMODE | ENS160_CACHE_CONFIG;
+  opModePending = false;
+  configPending = false;
+  switching = false;
+  if(cmdCount && (ENS160_IDLE_MODE == cachedOPMode)) {
+    cmdRestoreMode = healOPMode;   // Still in the IDLE phase of the commands, a command in progress is issued again
+    cmdState = CMD_STATE_ISSUE;
+  } else {
+    cmdState = CMD_STATE_NONE;
+    setPWRModeAsync(healOPMode);
+  }
+  setINTModeAsync(healConfig);
+  if(comp) {
+    if(sizeof(buf) == readReg(ENS160_TEMP_IN_REG, buf, sizeof(buf))) {   // TEMP_IN and RH_IN
+      cachedTempIn = ENS160_CONCAT_BYTES(buf[1], buf[0]);
+      cachedRHIn = ENS160_CONCAT_BYTES(buf[3], buf[2]);
+      cacheFlags |= ENS160_CACHE_TEMP_HUM;
+    }
+    writeTempAndHum(temp, rh);
+  }
+  if(misrCheck) {
+    misr = getMISR();
+  }
+  recovering = false;
+  healErrors = 0;
+  healCheck = now;
+  healStats.recoveries++;
+  DBG("recovered");
+  return NO_ERR;
+}
+
+/************************** Bus statistics function ******************************/
+#ifdef ENABLE_BUS_STATS
+void DFRobot_ENS160::getBusStats(sBusStats_t *stats)
+{
+  if(NULL == stats) {
+    return;
+  }
+  *stats = busStats;
+  if(0 == busStats.transactions) {
+    stats->minLatency = 0;
+    stats->avgLatency = 0;
+  } else {
+    stats->avgLatency = (uint32_t)(busLatencySum / busStats.transactions);
+  }
+}
+
+void DFRobot_ENS160::resetBusStats(void)
+{
+  memset(&busStats, 0, sizeof(busStats));
+  busStats.minLatency = 0xFFFFFFFF;
+  busLatencySum = 0;
+}
+
+void DFRobot_ENS160::recordBusStats(uint32_t latency, size_t bytes, bool ok)
+{
+  busStats.transactions++;
+  busStats.bytes += bytes;
+  if(!ok) {
+    busStats.failures++;
+  }
+  if(latency < busStats.minLatency) {
+    busStats.minLatency = latency;
+  }
+  if(latency > busStats.maxLatency) {
+    busStats.maxLatency = latency;
+  }
+  busLatencySum += latency;
+}
+#endif
+
 /************************** crc check calculation function ******************************/
 uint8_t DFRobot_ENS160::getMISR(void)
 {
@@ -113,110 +903,113 @@ uint8_t DFRobot_ENS160::calcMISR(uint8_t data)
   return misr;
 }
 
+size_t DFRobot_ENS160::readDataReg(uint8_t reg, void* pBuf, size_t size)
+{
+  size_t count = readReg(reg, pBuf, size);
+  uint8_t * _pBuf = (uint8_t *)pBuf;
+  for(size_t i = 0; i < count; i++) {
+    calcMISR(_pBuf[i]);   // The sensor updates DATA_MISR with every byte it sends
+  }
+  return count;
+}
+
 /***************** Init and read/write of I2C and SPI interfaces ******************************/
+#ifdef ARDUINO
 
 DFRobot_ENS160_I2C::DFRobot_ENS160_I2C(TwoWire *pWire, uint8_t i2cAddr)
+  :_bus(pWire, i2cAddr)
 {
-  _deviceAddr = i2cAddr;
-  _pWire = pWire;
 }
 
 int DFRobot_ENS160_I2C::begin(void)
 {
-  _pWire->begin();   // Wire.h(I2C)library function initialize wire library
+  _bus.begin();
   return DFRobot_ENS160::begin();   // Use the initialization function of the parent class
 }
 
-void DFRobot_ENS160_I2C::writeReg(uint8_t reg, const void* pBuf, size_t size)
+int DFRobot_ENS160_I2C::beginAsync(void)
 {
-  if(pBuf == NULL) {
-    DBG("pBuf ERROR!! : null pointer");
-  }
-  uint8_t * _pBuf = (uint8_t *)pBuf;
+  _bus.begin();
+  return DFRobot_ENS160::beginAsync();
+}
 
-  _pWire->beginTransmission(_deviceAddr);
-  _pWire->write(reg);
+int DFRobot_ENS160_I2C::beginWarm(const sWarmState_t *state, uint32_t offTime)
+{
+  _bus.begin();
+  return DFRobot_ENS160::beginWarm(state, offTime);
+}
 
-  for(size_t i = 0; i < size; i++) {
-    _pWire->write(_pBuf[i]);
-  }
-  _pWire->endTransmission();
+void DFRobot_ENS160_I2C::setRetries(uint8_t retries)
+{
+  _bus.setRetries(retries);
 }
 
-size_t DFRobot_ENS160_I2C::readReg(uint8_t reg, void* pBuf, size_t size)
+void DFRobot_ENS160_I2C::setRecoveryPins(uint8_t sdaPin, uint8_t sclPin)
 {
-  size_t count = 0;
-  if(NULL == pBuf) {
-    DBG("pBuf ERROR!! : null pointer");
-  }
-  uint8_t * _pBuf = (uint8_t*)pBuf;
+  _bus.setRecoveryPins(sdaPin, sclPin);
+}
 
-  _pWire->beginTransmission(_deviceAddr);
-  _pWire -> write(reg);
-  if(0 != _pWire->endTransmission()) {   // Used Wire.endTransmission() to end a slave transmission started by beginTransmission() and arranged by write().
-    DBG("endTransmission ERROR!!");
-  } else {
-    _pWire->requestFrom(_deviceAddr, (uint8_t)size);   // Master device requests size bytes from slave device, which can be accepted by master device with read() or available()
-    
-    while (_pWire->available()) {
-      _pBuf[count++] = _pWire->read();   // Use read() to receive and put into buf
-    }
-    // _pWire->endTransmission();
-  }
+bool DFRobot_ENS160_I2C::recoverBus(void)
+{
+  return _bus.recoverBus();
+}
+
+void DFRobot_ENS160_I2C::writeReg(uint8_t reg, const void* pBuf, size_t size)
+{
+  BUS_STATS_BEGIN();
+  bool ok = _bus.writeReg(reg, pBuf, size);
+  BUS_STATS_END(size, ok);
+}
+
+size_t DFRobot_ENS160_I2C::readReg(uint8_t reg, void* pBuf, size_t size)
+{
+  BUS_STATS_BEGIN();
+  size_t count = _bus.readReg(reg, pBuf, size);
+  BUS_STATS_END(count, size == count);
   return count;
 }
 
-DFRobot_ENS160_SPI::DFRobot_ENS160_SPI(SPIClass *pSpi, uint8_t csPin)
+DFRobot_ENS160_SPI::DFRobot_ENS160_SPI(SPIClass *pSpi, uint8_t csPin, uint32_t clock)
+  :_bus(pSpi, csPin, clock)
 {
-  _pSpi = pSpi;
-  _csPin = csPin;
+}
+
+void DFRobot_ENS160_SPI::setClock(uint32_t clock)
+{
+  _bus.setClock(clock);
 }
 
 int DFRobot_ENS160_SPI::begin(void)
 {
-  pinMode(_csPin, OUTPUT);
-  digitalWrite(_csPin,HIGH);
-  _pSpi->begin();
+  _bus.begin();
   return DFRobot_ENS160::begin();
 }
 
-void DFRobot_ENS160_SPI::writeReg(uint8_t reg, const void* pBuf, size_t size)
+int DFRobot_ENS160_SPI::beginAsync(void)
 {
-  if(NULL == pBuf) {
-    DBG("pBuf ERROR!! : null pointer");
-  }
-  uint8_t * _pBuf = (uint8_t *)pBuf;
-
-  _pSpi->beginTransaction(SPISettings(2000000, MSBFIRST, SPI_MODE0));
-  digitalWrite(_csPin, LOW);
-  _pSpi->transfer((reg << 1) & 0xFE);
-  while(size--) {
-    _pSpi->transfer(*_pBuf);
-    _pBuf++;
-  }
-  digitalWrite(_csPin, HIGH);
-  _pSpi->endTransaction();
+  _bus.begin();
+  return DFRobot_ENS160::beginAsync();
 }
 
-size_t DFRobot_ENS160_SPI::readReg(uint8_t reg, void* pBuf, size_t size)
+int DFRobot_ENS160_SPI::beginWarm(const sWarmState_t *state, uint32_t offTime)
 {
-  if(NULL == pBuf) {
-    DBG("pBuf ERROR!! : null pointer");
-  }
-  uint8_t * _pBuf = (uint8_t *)pBuf;
+  _bus.begin();
+  return DFRobot_ENS160::beginWarm(state, offTime);
+}
 
-  size_t count = 0;
-  _pSpi->beginTransaction(SPISettings(2000000, MSBFIRST, SPI_MODE0));
-  digitalWrite(_csPin, LOW);
-  _pSpi->transfer((reg << 1) | 0x01);
-  // _pSpi->transfer(0x00);
-  while(size--) {
-    *_pBuf = _pSpi->transfer(0x00);
-    _pBuf++;
-    count++;
-  }
-  _pSpi->endTransaction();
-  digitalWrite(_csPin, HIGH);
+void DFRobot_ENS160_SPI::writeReg(uint8_t reg, const void* pBuf, size_t size)
+{
+  BUS_STATS_BEGIN();
+  _bus.writeReg(reg, pBuf, size);
+  BUS_STATS_END(size, true);
+}
 
+size_t DFRobot_ENS160_SPI::readReg(uint8_t reg, void* pBuf, size_t size)
+{
+  BUS_STATS_BEGIN();
+  size_t count = _bus.readReg(reg, pBuf, size);
+  BUS_STATS_END(count, size == count);
   return count;
 }
+
+#endif   // ARDUINO
@@ -14,21 +14,63 @@
 #ifndef __DFRobot_ENS160_H__
 #define __DFRobot_ENS160_H__
 
-#include <Arduino.h>
-#include <Wire.h>
-#include <SPI.h>
+#ifdef ARDUINO
+  #include <Arduino.h>
+  #include <Wire.h>
+  #include <SPI.h>
+#else
+  #include "linux/DFRobot_ENS160_Host.h"   // millis(), micros(), yield() ... of host builds
+#endif
 
 
 // #define ENABLE_DBG   //!< Open this macro and you can see the details of the program
-#ifdef ENABLE_DBG
+#if defined(ENABLE_DBG) && defined(ARDUINO)
   #define DBG(...) {Serial.print("[");Serial.print(__FUNCTION__); Serial.print("(): "); Serial.print(__LINE__); Serial.print(" ] "); Serial.println(__VA_ARGS__);}
+#elif defined(ENABLE_DBG)
+  #define DBG(...) {std::cerr << "[" << __FUNCTION__ << "(): " << __LINE__ << " ] " << __VA_ARGS__ << std::endl;}
 #else
   #define DBG(...)
 #endif
 
+// #define ENABLE_BUS_STATS   //!< Open this macro to count the bus transactions, bytes, failures and latency, see getBusStats()
+#ifdef ENABLE_BUS_STATS
+  #define BUS_STATS_BEGIN()   uint32_t _busStart = micros()
+  #define BUS_STATS_END(bytes, ok)   recordBusStats(micros() - _busStart, (bytes), (ok))
+#else
+  #define BUS_STATS_BEGIN()
+  #define BUS_STATS_END(bytes, ok)   (void)(ok)
+#endif
+
 
 #define POLY   uint8_t(0x1D)   ///< 0b00011101 = x^8+x^4+x^3+x^2+x^0 (x^8 is implicit)
 #define ENS160_PART_ID   uint16_t(0x160)   ///< ENS160 chip version
+#define ENS160_SWITCH_TIME   20   ///< Time the sensor needs to switch mode or config, unit: ms
+
+/* Shadow register cache valid flags */
+#define ENS160_CACHE_OPMODE     uint8_t(0x01)   ///< OPMODE shadow is valid
+#define ENS160_CACHE_CONFIG     uint8_t(0x02)   ///< CONFIG shadow is valid
+#define ENS160_CACHE_TEMP_HUM   uint8_t(0x04)   ///< TEMP_IN and RH_IN shadows are valid
+#define ENS160_CACHE_STATUS     uint8_t(0x08)   ///< Last DATA_STATUS is valid
+
+#define ENS160_WARM_MAGIC   uint8_t(0xA5)   ///< Marks a saved sWarmState_t
+
+/* Command pipeline */
+#ifndef ENS160_CMD_QUEUE_SIZE
+  #define ENS160_CMD_QUEUE_SIZE   4   ///< Commands that can be queued at the same time
+#endif
+#define ENS160_CMD_TIMEOUT      100   ///< Time a command may take to answer in GPR_READ, unit: ms
+#define ENS160_CMD_POLL_TIME    2   ///< Period of the DATA_STATUS checks while a command runs, unit: ms
+
+/* Self-healing, see setSelfHealing() */
+#define ENS160_HEAL_ERRORS        3   ///< Consecutive failed or corrupted reads that start a recovery
+#define ENS160_HEAL_CHECK_TIME    10000   ///< Period of the OPMODE/CONFIG check, unit: ms
+#define ENS160_HEAL_BACKOFF_MIN   100   ///< Wait before the second recovery attempt, doubled after each failure, unit: ms
+#define ENS160_HEAL_BACKOFF_MAX   30000   ///< Longest wait between two recovery attempts, unit: ms
+
+/* Default policy of updateTempAndHum() */
+#define ENS160_COMP_TEMP_THRESHOLD   50   ///< 0.50 C
+#define ENS160_COMP_HUM_THRESHOLD    100   ///< 1.00 %rH
+#define ENS160_COMP_MAX_AGE          60000   ///< 60 s
 
 /* ENS160 register address */
 #define ENS160_PART_ID_REG     uint8_t(0x00)   ///< This 2-byte register contains the part number in little endian of the ENS160.
@@ -75,6 +117,9 @@ public:
   #define NO_ERR             0    // No error
   #define ERR_DATA_BUS     (-1)   // Data bus error
   #define ERR_IC_VERSION   (-2)   // Chip version error
+  #define ERR_MISR_CHECK   (-3)   // Data integrity (MISR) check error
+  #define ERR_CMD_TIMEOUT  (-4)   // Command did not answer in time
+  #define ERR_SENSOR_FAULT (-5)   // Sensor reset, error flag or repeated bus errors, the driver is re-initialising it
 
 /************************* Interrupt Pin Configuration *******************************/
   /**
@@ -160,6 +205,127 @@ public:
     uint8_t   status: 1; /**< High indicates that an OPMODE is running */
   } __attribute__ ((packed)) sSensorStatus_t;
 
+/************************* Measured data snapshot *******************************/
+  /**
+   * @struct sSnapshot_t
+   * @brief One complete sample decoded from the contiguous DATA_STATUS..DATA_ECO2 registers (0x20-0x25)
+   * @note All fields come from the same burst read, so they belong to the same conversion cycle
+   */
+  typedef struct
+  {
+    sSensorStatus_t   status; /**< DATA_STATUS register */
+    uint8_t   AQI; /**< Air quality index according to the UBA, range: 1-5 */
+    uint16_t   TVOC; /**< TVOC concentration, range: 0-65000, unit: ppb */
+    uint16_t   ECO2; /**< CO2 equivalent concentration, range: 400-65000, unit: ppm */
+    uint8_t   stale; /**< 0: read and verified now; 1: the read failed, the values are those of the last good sample */
+  } sSnapshot_t;
+
+  /**
+   * @struct sTimedSnapshot_t
+   * @brief A sample together with the time it was taken
+   */
+  typedef struct
+  {
+    uint32_t   timestamp; /**< millis() when the data became ready */
+    sSnapshot_t   data; /**< The sample */
+  } sTimedSnapshot_t;
+
+  /**
+   * @struct sGPRData_t
+   * @brief Raw resistance of the four hot plates, decoded from GPR_READ0..GPR_READ7 (0x48-0x4F)
+   * @note Use rawToOhm() to convert a raw value into resistance
+   */
+  typedef struct
+  {
+    uint16_t   hp0Raw; /**< Raw resistance of hot plate 0 */
+    uint16_t   hp1Raw; /**< Raw resistance of hot plate 1 */
+    uint16_t   hp2Raw; /**< Raw resistance of hot plate 2 */
+    uint16_t   hp3Raw; /**< Raw resistance of hot plate 3 */
+  } sGPRData_t;
+
+  /**
+   * @struct sMISRStats_t
+   * @brief Counters of the data integrity (MISR) check
+   */
+  typedef struct
+  {
+    uint32_t   checked; /**< Number of samples verified against DATA_MISR */
+    uint32_t   mismatch; /**< Number of samples whose checksum did not match */
+  } sMISRStats_t;
+
+  /**
+   * @struct sHealthStats_t
+   * @brief Counters of the self-healing, see setSelfHealing()
+   */
+  typedef struct
+  {
+    uint32_t   faults; /**< Faults that started a recovery */
+    uint32_t   attempts; /**< Re-initialisations tried */
+    uint32_t   recoveries; /**< Re-initialisations that succeeded */
+    uint32_t   staleSamples; /**< Samples of readSnapshot() returned as stale */
+  } sHealthStats_t;
+
+  /**
+   * @struct sWarmState_t
+   * @brief Sensor state saved by getWarmState() and checked by beginWarm() after an MCU reset
+   * @note Keep it in memory that survives the reset (EEPROM, RTC RAM, a no-init section)
+   */
+  typedef struct
+  {
+    uint8_t   magic; /**< ENS160_WARM_MAGIC when the state is valid */
+    uint16_t   partID; /**< PART_ID verified by begin() */
+    uint8_t   opMode; /**< OPMODE register */
+    uint8_t   config; /**< CONFIG register */
+    uint8_t   validity; /**< Validity flag of the last DATA_STATUS read, eInvalidOutput if none was read */
+    uint8_t   compValid; /**< 1: tempIn and rhIn hold the compensation last written */
+    uint16_t   tempIn; /**< TEMP_IN register */
+    uint16_t   rhIn; /**< RH_IN register */
+    uint32_t   heaterOnTime; /**< Time the sensor had been in STANDARD mode, unit: ms */
+    uint8_t   checksum; /**< CRC of the fields above */
+  } __attribute__ ((packed)) sWarmState_t;
+
+  /**
+   * @struct sAppVersion_t
+   * @brief Firmware version returned by ENS160_COMMAND_GET_APPVER in GPR_READ4..GPR_READ6
+   */
+  typedef struct
+  {
+    uint8_t   major; /**< Major version */
+    uint8_t   minor; /**< Minor version */
+    uint8_t   release; /**< Release version */
+  } sAppVersion_t;
+
+  /**
+   * @brief Called when a queued command completes
+   * @param command The command
+   * @param result NO_ERR, ERR_DATA_BUS or ERR_CMD_TIMEOUT
+   * @param gpr The 8 GPR_READ registers, all 0 if result is not NO_ERR
+   */
+  typedef void (*commandCallback_t)(uint8_t command, int result, const uint8_t *gpr);
+
+  /**
+   * @brief Called with every sample read successfully by readSnapshot()
+   * @param snapshot The sample
+   * @param arg The argument given to setSampleCallback()
+   */
+  typedef void (*sampleCallback_t)(const sSnapshot_t *snapshot, void *arg);
+
+#ifdef ENABLE_BUS_STATS
+  /**
+   * @struct sBusStats_t
+   * @brief Counters of the register read/write transactions, only available with ENABLE_BUS_STATS
+   */
+  typedef struct
+  {
+    uint32_t   transactions; /**< Number of readReg() and writeReg() calls */
+    uint32_t   bytes; /**< Data bytes transferred */
+    uint32_t   failures; /**< Transactions that failed, e.g. NACK or fewer bytes than requested */
+    uint32_t   minLatency; /**< Shortest transaction, unit: us */
+    uint32_t   avgLatency; /**< Average transaction, unit: us */
+    uint32_t   maxLatency; /**< Longest transaction, unit: us */
+  } sBusStats_t;
+#endif
+
 public:
 
 /************************ Init ********************************/
@@ -180,6 +346,17 @@ public:
    */
   virtual int begin(void);
 
+  /**
+   * @fn beginAsync
+   * @brief Non-blocking init function, checks the chip and queues the default mode and config,
+   * @n     call poll() until it returns true before using the sensor
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int beginAsync(void);
+
 /************************** Config function ******************************/
   /**
    * @fn setPWRMode
@@ -189,6 +366,8 @@ public:
    * @n       ENS160_IDLE_MODE: IDLE mode (low-power)
    * @n       ENS160_STANDARD_MODE: STANDARD Gas Sensing Modes
    * @return None
+   * @note Waits for the mode transition only, not for queued commands. While commands run the mode
+   * @n    is switched to after the last one, see queueCommand().
    */
   void setPWRMode(uint8_t mode);
 
@@ -199,10 +378,42 @@ public:
    * @n       Interrupt setting (the interrupt occur when a new data is uploaded): eINTModeDIS-Disable interrupt, eINTModeEN-Enable interrupt
    * @n       Interrupt pin output driving mode: eINTPinOD-Open drain output, eINTPinPP-Push pull output
    * @n       Interrupt pin active level: eINTPinActiveLow-Active low, eINTPinActiveHigh-Active high
+   * @n       Interrupt source: by default the interrupt occurs when new data appear in DATA_XXX,
+   * @n         with eIntGprDrdyEN it occurs when new data appear in GPR_READ instead (see readGPR())
    * @return None
    */
   void setINTMode(uint8_t mode);
 
+  /**
+   * @fn setPWRModeAsync
+   * @brief Set power mode without waiting for the sensor to switch, see setPWRMode()
+   * @param mode Configurable power mode
+   * @return None
+   */
+  void setPWRModeAsync(uint8_t mode);
+
+  /**
+   * @fn setINTModeAsync
+   * @brief Interrupt config (INT) without waiting for the sensor to switch, see setINTMode()
+   * @param mode Interrupt mode to be set
+   * @return None
+   */
+  void setINTModeAsync(uint8_t mode);
+
+  /**
+   * @fn poll
+   * @brief Drive the pending mode and config transitions and the queued commands, based on millis()
+   * @return true: all transitions and commands are done, the sensor is ready; false: still busy
+   */
+  bool poll(void);
+
+  /**
+   * @fn isReady
+   * @brief Check whether all pending mode and config transitions and commands are done, without touching the bus
+   * @return true: ready; false: busy
+   */
+  bool isReady(void);
+
   /**
    * @fn setTempAndHum
    * @brief Users write ambient temperature and relative humidity into ENS160 for calibration compensation of the measured gas data.
@@ -212,6 +423,175 @@ public:
    */
   void setTempAndHum(float ambientTemp, float relativeHumidity);
 
+  /**
+   * @fn setTempAndHumFixed
+   * @brief Same as setTempAndHum(), with fixed-point arguments and integer conversion only
+   * @param ambientTemp Compensate the current ambient temperature, unit: 0.01 C, clamped to -40.00 - 85.00 C
+   * @param relativeHumidity Compensate the current ambient humidity, unit: 0.01 %rH, clamped to 0.00 - 100.00 %rH
+   * @return None
+   */
+  void setTempAndHumFixed(int16_t ambientTemp, uint16_t relativeHumidity);
+
+  /**
+   * @fn encodeTempAndHum
+   * @brief Convert the arguments of setTempAndHumFixed() into TEMP_IN and RH_IN register values,
+   * @n     shared with DFRobot_ENS160_Fast
+   * @param ambientTemp Ambient temperature, unit: 0.01 C, clamped to -40.00 - 85.00 C
+   * @param relativeHumidity Ambient humidity, unit: 0.01 %rH, clamped to 0.00 - 100.00 %rH
+   * @param temp TEMP_IN value, unit: 1/64 K
+   * @param rh RH_IN value, unit: 1/512 %rH
+   * @return None
+   */
+  static inline void encodeTempAndHum(int16_t ambientTemp, uint16_t relativeHumidity, uint16_t *temp, uint16_t *rh)
+  {
+    ambientTemp = constrain(ambientTemp, -4000, 8500);
+    if(relativeHumidity > 10000) {
+      relativeHumidity = 10000;
+    }
+    *temp = ((int32_t)ambientTemp + 27315) * 64 / 100;   // 0.01 C to 1/64 K
+    *rh = (uint32_t)relativeHumidity * 512 / 100;   // 0.01 %rH to 1/512 %rH
+  }
+
+  /**
+   * @fn setCompensationPolicy
+   * @brief Configure when updateTempAndHum() writes the sensor
+   * @param tempThreshold Minimum temperature change since the last write, unit: 0.01 C
+   * @param humThreshold Minimum humidity change since the last write, unit: 0.01 %rH
+   * @param maxAge The values are written again when the last write is older than this, unit: ms
+   * @return None
+   */
+  void setCompensationPolicy(uint16_t tempThreshold, uint16_t humThreshold, uint32_t maxAge);
+
+  /**
+   * @fn updateTempAndHum
+   * @brief Rate-limited setTempAndHumFixed(), can be called with every new reading of the temperature
+   * @n     and humidity sensor, the sensor is only written when the change exceeds a threshold or
+   * @n     the last write is older than maxAge, see setCompensationPolicy()
+   * @param ambientTemp Current ambient temperature, unit: 0.01 C
+   * @param relativeHumidity Current ambient humidity, unit: 0.01 %rH
+   * @return true: the sensor was written; false: the update was skipped
+   */
+  bool updateTempAndHum(int16_t ambientTemp, uint16_t relativeHumidity);
+
+/************************** Shadow register cache ******************************/
+  /**
+   * @fn getCachedPWRMode
+   * @brief Get the power mode last written to or read from OPMODE, without touching the bus
+   * @return Power mode, valid when getCacheFlags() contains ENS160_CACHE_OPMODE
+   */
+  uint8_t getCachedPWRMode(void);
+
+  /**
+   * @fn getCachedINTMode
+   * @brief Get the value last written to or read from CONFIG, without touching the bus
+   * @return Interrupt config, valid when getCacheFlags() contains ENS160_CACHE_CONFIG
+   */
+  uint8_t getCachedINTMode(void);
+
+  /**
+   * @fn getCachedStatus
+   * @brief Get the DATA_STATUS of the last getENS160Status() or readSnapshot(), without touching the bus
+   * @return Sensor status, valid when getCacheFlags() contains ENS160_CACHE_STATUS
+   */
+  sSensorStatus_t getCachedStatus(void);
+
+  /**
+   * @fn getCacheFlags
+   * @brief Get which shadow registers are valid
+   * @return OR of ENS160_CACHE_OPMODE, ENS160_CACHE_CONFIG, ENS160_CACHE_TEMP_HUM and ENS160_CACHE_STATUS
+   */
+  uint8_t getCacheFlags(void);
+
+  /**
+   * @fn invalidateCache
+   * @brief Mark all shadow registers invalid, e.g. after a sensor reset or bus error,
+   * @n     so the next setPWRMode(), setINTMode() and setTempAndHum() write the sensor unconditionally
+   * @return None
+   */
+  void invalidateCache(void);
+
+  /**
+   * @fn resyncCache
+   * @brief Read OPMODE, CONFIG, TEMP_IN, RH_IN and DATA_STATUS from the sensor into the shadow registers
+   * @return int type, indicates the read result
+   * @retval 0 NO_ERR
+   * @retval -1 ERR_DATA_BUS
+   */
+  int resyncCache(void);
+
+/************************** Warm start ******************************/
+  /**
+   * @fn getWarmState
+   * @brief Save the sensor state from the shadow registers, without touching the bus
+   * @param state Storage for the state, magic is 0 if begin() has not completed, may be NULL
+   * @return None
+   */
+  void getWarmState(sWarmState_t *state);
+
+  /**
+   * @fn beginWarm
+   * @brief Init function after an MCU reset with the sensor still powered
+   * @details PART_ID is checked, then OPMODE and CONFIG are read in one transaction. If they match the
+   * @n       saved state, the writes and switch delays of begin() are skipped and the sensor keeps its
+   * @n       warm-up progress; otherwise, or if the state is not valid, it falls back to begin().
+   * @n       In STANDARD mode with a saved validity flag, DATA_STATUS is read too: a phase earlier than
+   * @n       the saved one means the sensor was reset in between, which falls back to begin() as well.
+   * @param state State saved by getWarmState() before the reset
+   * @param offTime Time between saving the state and this call if known, e.g. from an RTC, unit: ms
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int beginWarm(const sWarmState_t *state, uint32_t offTime = 0);
+
+  /**
+   * @fn getHeaterOnTime
+   * @brief Get how long the sensor has been in STANDARD mode, including the time carried over by beginWarm()
+   * @return unit: ms, 0 when the sensor is not in STANDARD mode
+   */
+  uint32_t getHeaterOnTime(void);
+
+/************************** Command pipeline ******************************/
+  /**
+   * @fn queueCommand
+   * @brief Queue a command, it is run by poll() once the pending mode and config transitions are done
+   * @details The sensor only accepts commands in IDLE mode: poll() switches to IDLE, writes COMMAND,
+   * @n       calls the callback and switches back. For GET_APPVER it clears GPR_READ first and waits for
+   * @n       NEWGPR (or onGPRReady()) before reading the answer. All commands queued before the switch
+   * @n       back is written, including those queued from a callback, run back to back in one IDLE phase.
+   * @note Unlike a background command channel, this interrupts the measurement: leaving STANDARD mode
+   * @n    restarts the 3 minute warm-up. Queue commands right after beginAsync(), or all at once.
+   * @param command ENS160_COMMAND_GET_APPVER, ENS160_COMMAND_CLRGPR or ENS160_COMMAND_NOP
+   * @param callback Function called with the result, may be NULL
+   * @return true: queued; false: the queue is full
+   */
+  bool queueCommand(uint8_t command, commandCallback_t callback);
+
+  /**
+   * @fn getCommandCount
+   * @brief Get the number of queued commands, including the running one
+   * @return Number of commands
+   */
+  uint8_t getCommandCount(void);
+
+  /**
+   * @fn onGPRReady
+   * @brief Tell the pipeline that NEWGPR is set, e.g. from the interrupt handler of the INT pin
+   * @n     configured with eIntGprDrdyEN; saves the DATA_STATUS checks
+   * @return None
+   */
+  void onGPRReady(void);
+
+  /**
+   * @fn decodeAppVersion
+   * @brief Decode the GPR_READ registers of ENS160_COMMAND_GET_APPVER
+   * @param gpr The 8 GPR_READ registers passed to the callback
+   * @param version Storage for the version
+   * @return None
+   */
+  static void decodeAppVersion(const uint8_t *gpr, sAppVersion_t *version);
+
 /************************** Performance function ******************************/
   /**
    * @fn getENS160Status
@@ -247,6 +627,130 @@ public:
    */
   uint16_t getECO2(void);
 
+  /**
+   * @fn readSnapshot
+   * @brief Read status, AQI, TVOC and eCO2 in one bus transaction
+   * @param snapshot Storage for the decoded sample
+   * @return int type, indicates the read result
+   * @retval 0 NO_ERR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -3 ERR_MISR_CHECK (only when the MISR check is enabled)
+   * @retval -5 ERR_SENSOR_FAULT (only with self-healing enabled)
+   * @note The values of the four getters above each cost a separate register read,
+   * @n    this API reads the whole DATA_STATUS..DATA_ECO2 block at once.
+   * @n    On an error snapshot holds the last good sample with stale set.
+   */
+  int readSnapshot(sSnapshot_t *snapshot);
+
+  /**
+   * @fn setSampleCallback
+   * @brief Set a function that sees every sample read by readSnapshot(), e.g. DFRobot_ENS160_Events
+   * @param callback The function, NULL removes it
+   * @param arg Passed to the function
+   * @return None
+   */
+  void setSampleCallback(sampleCallback_t callback, void *arg = NULL);
+
+  /**
+   * @fn readGPR
+   * @brief Read the raw hot plate resistances from the 8 GPR_READ registers in one bus transaction
+   * @param gpr Storage for the decoded raw values
+   * @return int type, indicates the read result
+   * @retval 0 NO_ERR
+   * @retval -1 ERR_DATA_BUS
+   * @note The values are updated once per conversion, the NEWGPR status bit or the
+   * @n    eIntGprDrdyEN interrupt tells when they are new
+   */
+  int readGPR(sGPRData_t *gpr);
+
+  /**
+   * @fn rawToOhm
+   * @brief Convert a raw resistance value of readGPR() into resistance
+   * @param raw Raw value
+   * @return Resistance, unit: ohm
+   */
+  static float rawToOhm(uint16_t raw);
+
+/************************** Data integrity function ******************************/
+  /**
+   * @fn setMISRCheck
+   * @brief Enable or disable the data integrity check of readSnapshot()
+   * @param enable true: after each burst read, DATA_MISR is read and compared with the checksum
+   * @n                  calculated over the received bytes; false: no check (default)
+   * @return None
+   * @note Enabling the check resynchronizes the local checksum mirror with the sensor
+   */
+  void setMISRCheck(bool enable);
+
+  /**
+   * @fn getMISRStats
+   * @brief Get the counters of the data integrity check
+   * @param stats Storage for the counters
+   * @return None
+   */
+  void getMISRStats(sMISRStats_t *stats);
+
+/************************** Self-healing function ******************************/
+  /**
+   * @fn setSelfHealing
+   * @brief Enable or disable the self-healing of readSnapshot()
+   * @details Every sample is then checked for the STATER error flag and for an OPMODE that stopped running,
+   * @n       OPMODE and CONFIG are compared with the cache every ENS160_HEAL_CHECK_TIME ms.
+   * @n       The error flag, a changed register (e.g. the sensor browned out into DEEP SLEEP) or ENS160_HEAL_ERRORS
+   * @n       consecutive failed or MISR-corrupted reads start a recovery: PART_ID is checked, and those of the
+   * @n       last OPMODE, CONFIG and compensation the sensor lost are written again, so that a sensor that only
+   * @n       saw bus errors keeps its warm-up progress. A failed attempt is retried after a wait that
+   * @n       doubles from ENS160_HEAL_BACKOFF_MIN to ENS160_HEAL_BACKOFF_MAX.
+   * @param enable true: enable; false: disable (default)
+   * @return None
+   */
+  void setSelfHealing(bool enable);
+
+  /**
+   * @fn checkHealth
+   * @brief Run the checks of the self-healing once and recover at once if they fail, or make the next
+   * @n     recovery attempt if one is due
+   * @n     For applications that use the single value getters instead of readSnapshot()
+   * @return int type
+   * @retval 0 NO_ERR (healthy, or initialised again)
+   * @retval -1 ERR_DATA_BUS
+   * @retval -5 ERR_SENSOR_FAULT (not recovered yet)
+   */
+  int checkHealth(void);
+
+  /**
+   * @fn isRecovering
+   * @brief Whether a fault was detected and the sensor is not initialised again yet
+   * @return true: recovering; false: healthy
+   */
+  bool isRecovering(void);
+
+  /**
+   * @fn getHealthStats
+   * @brief Get the counters of the self-healing
+   * @param stats Storage for the counters
+   * @return None
+   */
+  void getHealthStats(sHealthStats_t *stats);
+
+#ifdef ENABLE_BUS_STATS
+/************************** Bus statistics function ******************************/
+  /**
+   * @fn getBusStats
+   * @brief Get the counters of the register read/write transactions, only available with ENABLE_BUS_STATS
+   * @param stats Storage for the counters
+   * @return None
+   */
+  void getBusStats(sBusStats_t *stats);
+
+  /**
+   * @fn resetBusStats
+   * @brief Clear the counters of the register read/write transactions
+   * @return None
+   */
+  void resetBusStats(void);
+#endif
+
 protected:
 
 /************************** crc check calculation function and command sending function ******************************/
@@ -265,6 +769,90 @@ protected:
    */
   uint8_t calcMISR(uint8_t data);
 
+  /**
+   * @fn readDataReg
+   * @brief Read DATA_XXX registers and update the crc check code mirror with every received byte
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be read
+   * @param size Length of data to be read
+   * @return Return the read length, returning 0 means reading failed
+   */
+  size_t readDataReg(uint8_t reg, void* pBuf, size_t size);
+
+  /**
+   * @fn writeTempAndHum
+   * @brief Write TEMP_IN and RH_IN in one transaction and update their shadows
+   * @param temp TEMP_IN value, unit: 1/64 K
+   * @param rh RH_IN value, unit: 1/512 %rH
+   * @return None
+   * @note The write is skipped when the shadows are valid and hold the same values
+   */
+  void writeTempAndHum(uint16_t temp, uint16_t rh);
+
+  /**
+   * @fn warmChecksum
+   * @brief Calculate the CRC of a saved state, with the same polynomial as DATA_MISR
+   * @param state The state
+   * @return CRC over all fields except checksum
+   */
+  static uint8_t warmChecksum(const sWarmState_t *state);
+
+  /**
+   * @fn pollCommand
+   * @brief Advance the command at the head of the queue by one step, called by poll()
+   * @return true: no command is queued; false: a command is in progress
+   */
+  bool pollCommand(void);
+
+  /**
+   * @fn pollSwitch
+   * @brief Issue the next pending mode or config write once the sensor has switched, called by poll()
+   * @return true: all transitions are done; false: still switching
+   */
+  bool pollSwitch(void);
+
+  /**
+   * @fn healFault
+   * @brief Count a failed or corrupted read, starts a recovery after ENS160_HEAL_ERRORS in a row
+   * @param err The error of the read
+   * @return err, or ERR_SENSOR_FAULT if a recovery was started
+   */
+  int healFault(int err);
+
+  /**
+   * @fn verifyConfig
+   * @brief Compare OPMODE and CONFIG of the sensor with the cache, starts a recovery if they differ
+   * @return NO_ERR, ERR_DATA_BUS or ERR_SENSOR_FAULT
+   */
+  int verifyConfig(void);
+
+  /**
+   * @fn startRecovery
+   * @brief Remember the configuration to restore and schedule the first recovery attempt at once
+   * @return None
+   */
+  void startRecovery(void);
+
+  /**
+   * @fn tryRecover
+   * @brief Check the sensor and restore its configuration, if the backoff time has passed
+   * @n     Only the registers that differ from the configuration before the fault are written
+   * @return NO_ERR if the sensor is configured again, otherwise ERR_SENSOR_FAULT
+   */
+  int tryRecover(void);
+
+#ifdef ENABLE_BUS_STATS
+  /**
+   * @fn recordBusStats
+   * @brief Account one register transaction, used by BUS_STATS_END() in the bus implementations
+   * @param latency Duration of the transaction, unit: us
+   * @param bytes Data bytes transferred
+   * @param ok Whether the transaction succeeded
+   * @return None
+   */
+  void recordBusStats(uint32_t latency, size_t bytes, bool ok);
+#endif
+
 /************************** Register read/write port ******************************/
 
   /**
@@ -291,10 +879,71 @@ private:
   // Private variables
   sSensorStatus_t ENS160Status;
   uint8_t misr; // Mirror of DATA_MISR (0 is hardware default)
+  bool misrCheck; // Verify readSnapshot() against DATA_MISR
+  sMISRStats_t misrStats; // Counters of the data integrity check
+#ifdef ENABLE_BUS_STATS
+  sBusStats_t busStats;
+  uint64_t busLatencySum; // Sum of all transaction latencies, unit: us
+#endif
+
+  // Pending mode and config transitions
+  uint8_t pendingOPMode;
+  uint8_t pendingConfig;
+  bool opModePending;
+  bool configPending;
+  bool switching; // A write was issued and the sensor is still switching
+  uint32_t switchStart; // millis() of the last mode or config write
+  uint32_t heaterStart; // millis() when STANDARD mode was entered
+
+  // Command queue, run by poll()
+  uint8_t cmdQueue[ENS160_CMD_QUEUE_SIZE];
+  commandCallback_t cmdCallback[ENS160_CMD_QUEUE_SIZE];
+  uint8_t cmdHead;
+  uint8_t cmdCount;
+  uint8_t cmdState;
+  uint8_t cmdRestoreMode; // OPMODE to switch back to after the commands
+  uint32_t cmdStart; // millis() of the COMMAND write
+  uint32_t cmdCheck; // millis() of the last DATA_STATUS check
+  volatile bool gprReady; // Set by onGPRReady()
+
+  sampleCallback_t sampleCallback; // Sees every sample of readSnapshot()
+  void *sampleArg;
+  sSnapshot_t lastSnapshot; // Last good sample, returned as stale when a read fails
+
+  // Self-healing
+  bool selfHealing;
+  bool recovering;
+  uint8_t healErrors; // Consecutive failed or corrupted reads
+  uint8_t healOPMode; // OPMODE and CONFIG to restore
+  uint8_t healConfig;
+  bool healComp; // Compensation was written before the fault
+  uint32_t healCheck; // millis() of the last OPMODE/CONFIG check
+  uint32_t healTime; // millis() of the last recovery attempt
+  uint32_t healBackoff; // Wait before the next attempt, unit: ms
+  sHealthStats_t healStats;
+
+  // Write-through shadow of the config registers
+  uint8_t cacheFlags;
+  uint8_t cachedOPMode;
+  uint8_t cachedConfig;
+  uint16_t cachedTempIn;
+  uint16_t cachedRHIn;
+
+  // Compensation policy and the last values written by updateTempAndHum()
+  uint16_t compTempThreshold;
+  uint16_t compHumThreshold;
+  uint32_t compMaxAge;
+  int16_t compTemp;
+  uint16_t compHum;
+  uint32_t compTime;
 };
 
 /************************** Init and read/write of I2C and SPI interfaces ******************************/
 
+#ifdef ARDUINO   // Linux hosts use linux/DFRobot_ENS160_Linux.h
+
+#include "DFRobot_ENS160_Bus.h"
+
 class DFRobot_ENS160_I2C:public DFRobot_ENS160
 {
 public:
@@ -317,6 +966,53 @@ public:
    */
   virtual int begin(void);
 
+  /**
+   * @fn beginAsync
+   * @brief Subclass non-blocking init function
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int beginAsync(void);
+
+  /**
+   * @fn beginWarm
+   * @brief Subclass warm-start init function
+   * @param state State saved by getWarmState() before the reset
+   * @param offTime Time between saving the state and this call if known, unit: ms
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int beginWarm(const sWarmState_t *state, uint32_t offTime = 0);
+
+  /**
+   * @fn setRetries
+   * @brief Set how many times a NACKed or short transfer is repeated before it fails
+   * @param retries Number of retries, 0 means no retry (default ENS160_I2C_RETRIES)
+   * @return None
+   */
+  void setRetries(uint8_t retries);
+
+  /**
+   * @fn setRecoveryPins
+   * @brief Set the SDA and SCL pins used to recover a hung bus, a transfer that still fails after
+   * @n     all retries then clocks SCL until the sensor releases SDA and inits the Wire library again
+   * @param sdaPin SDA pin number, e.g. SDA; ENS160_PIN_NONE disables the recovery (default)
+   * @param sclPin SCL pin number, e.g. SCL; ENS160_PIN_NONE disables the recovery (default)
+   * @return None
+   */
+  void setRecoveryPins(uint8_t sdaPin, uint8_t sclPin);
+
+  /**
+   * @fn recoverBus
+   * @brief Recover a hung bus now, see setRecoveryPins()
+   * @return true: SDA is released; false: no recovery pins or SDA is still held low
+   */
+  bool recoverBus(void);
+
 protected:
   /**
    * @fn writeReg
@@ -339,8 +1035,7 @@ protected:
   virtual size_t readReg(uint8_t reg, void* pBuf, size_t size);
 
 private:
-  TwoWire *_pWire;   // Pointer to I2C communication method
-  uint8_t _deviceAddr;   // Address of the device for I2C communication
+  DFRobot_ENS160_I2CBus _bus;   // I2C register access
 };
 
 class DFRobot_ENS160_SPI:public DFRobot_ENS160
@@ -351,9 +1046,18 @@ public:
    * @brief Constructor
    * @param pSpi extern SPIClass SPI is defined in SPI.h; so just get SPI object address and the methods in SPI can be pointed to and used
    * @param csPin The digital pin that only cs pin can connect to
+   * @param clock SPI clock, unit: Hz, limited to ENS160_SPI_MAX_CLOCK (10 MHz)
    * @return None
    */
-  DFRobot_ENS160_SPI(SPIClass *pSpi, uint8_t csPin);
+  DFRobot_ENS160_SPI(SPIClass *pSpi, uint8_t csPin, uint32_t clock=ENS160_SPI_CLOCK);
+
+  /**
+   * @fn setClock
+   * @brief Set the SPI clock
+   * @param clock SPI clock, unit: Hz, limited to ENS160_SPI_MAX_CLOCK (10 MHz)
+   * @return None
+   */
+  void setClock(uint32_t clock);
 
   /**
    * @fn begin
@@ -365,6 +1069,28 @@ public:
    */
   virtual int begin(void);
 
+  /**
+   * @fn beginAsync
+   * @brief Subclass non-blocking init function
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int beginAsync(void);
+
+  /**
+   * @fn beginWarm
+   * @brief Subclass warm-start init function
+   * @param state State saved by getWarmState() before the reset
+   * @param offTime Time between saving the state and this call if known, unit: ms
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int beginWarm(const sWarmState_t *state, uint32_t offTime = 0);
+
 protected:
   /**
    * @fn writeReg
@@ -387,8 +1113,9 @@ protected:
   virtual size_t readReg(uint8_t reg, void* pBuf, size_t size);
 
 private:
-  SPIClass *_pSpi;   // Pointer to SPI communication method
-  uint8_t _csPin;   // Cs pin of SPI communication
+  DFRobot_ENS160_SPIBus _bus;   // SPI register access
 };
 
+#endif   // ARDUINO
+
 #endif
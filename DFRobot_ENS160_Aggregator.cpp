@@ -0,0 +1,156 @@
+/*!
+ * @file DFRobot_ENS160_Aggregator.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Aggregator class
+ * @n Windowed aggregation of AQI, TVOC and eCO2 samples.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Aggregator.h"
+
+#define MEDIAN_MAX_STEP   1024   // Limit of the median estimator step
+
+DFRobot_ENS160_Aggregator::DFRobot_ENS160_Aggregator(uint32_t window, uint8_t emaShift)
+{
+  _window = window ? window : 1;
+  _emaShift = (emaShift > 8) ? 8 : emaShift;
+  memset(&_record, 0, sizeof(_record));
+  memset(&_AQI, 0, sizeof(_AQI));
+  memset(&_TVOC, 0, sizeof(_TVOC));
+  memset(&_ECO2, 0, sizeof(_ECO2));
+  reset();
+}
+
+void DFRobot_ENS160_Aggregator::reset(void)
+{
+  _started = false;
+  _emaValid = false;
+  _start = 0;
+  _count = 0;
+  _skipped = 0;
+}
+
+uint32_t DFRobot_ENS160_Aggregator::getNextBoundary(void)
+{
+  return _start + _window;
+}
+
+void DFRobot_ENS160_Aggregator::getAggregate(sAggregate_t *aggregate)
+{
+  if(NULL != aggregate) {
+    *aggregate = _record;
+  }
+}
+
+bool DFRobot_ENS160_Aggregator::update(const DFRobot_ENS160::sTimedSnapshot_t &sample)
+{
+  return update(sample.data, sample.timestamp);
+}
+
+bool DFRobot_ENS160_Aggregator::update(const DFRobot_ENS160::sSnapshot_t &sample, uint32_t timestamp)
+{
+  bool closed = false;
+
+  if(!_started) {
+    _started = true;
+    _start = timestamp;
+  } else if((uint32_t)(timestamp - _start) >= _window) {
+    _record.start = _start;
+    _record.length = _window;
+    _record.count = _count;
+    _record.skipped = _skipped;
+    closeChannel(&_AQI, &_record.AQI);
+    closeChannel(&_TVOC, &_record.TVOC);
+    closeChannel(&_ECO2, &_record.ECO2);
+    closed = true;
+
+    _start += ((timestamp - _start) / _window) * _window;   // Stay aligned to the window grid
+    _count = 0;
+    _skipped = 0;
+  }
+
+  if(DFRobot_ENS160::eInvalidOutput == sample.status.validityFlag) {
+    _skipped++;
+    return closed;
+  }
+
+  bool first = (0 == _count);
+  if(first) {
+    startChannel(&_AQI, sample.AQI);
+    startChannel(&_TVOC, sample.TVOC);
+    startChannel(&_ECO2, sample.ECO2);
+  }
+  addChannel(&_AQI, sample.AQI, !_emaValid);
+  addChannel(&_TVOC, sample.TVOC, !_emaValid);
+  addChannel(&_ECO2, sample.ECO2, !_emaValid);
+  _emaValid = true;
+  if(_count < 0xFFFF) {
+    _count++;
+  }
+  return closed;
+}
+
+void DFRobot_ENS160_Aggregator::startChannel(sChannel_t *ch, uint16_t value)
+{
+  ch->min = 0xFFFF;
+  ch->max = 0;
+  ch->sum = 0;
+  // The median belongs to this window only, seed it with the first sample
+  ch->median = value;
+  ch->step = 1;
+  ch->dir = 0;
+}
+
+void DFRobot_ENS160_Aggregator::addChannel(sChannel_t *ch, uint16_t value, bool first)
+{
+  if(value < ch->min) {
+    ch->min = value;
+  }
+  if(value > ch->max) {
+    ch->max = value;
+  }
+  ch->sum += value;
+
+  if(first) {
+    ch->ema = (int32_t)value << 8;
+  } else {
+    ch->ema += (((int32_t)value << 8) - ch->ema) >> _emaShift;
+  }
+
+  // Streaming median: step towards the sample, the step doubles while moving in the
+  // same direction and falls back to 1 when the direction changes
+  if(value == ch->median) {
+    return;
+  }
+  int8_t dir = (value > ch->median) ? 1 : -1;
+  if(dir == ch->dir) {
+    if(ch->step < MEDIAN_MAX_STEP) {
+      ch->step <<= 1;
+    }
+  } else {
+    ch->step = 1;
+  }
+  ch->dir = dir;
+  if(dir > 0) {
+    ch->median = ((uint32_t)ch->median + ch->step > value) ? value : ch->median + ch->step;
+  } else {
+    ch->median = ((int32_t)ch->median - ch->step < (int32_t)value) ? value : ch->median - ch->step;
+  }
+}
+
+void DFRobot_ENS160_Aggregator::closeChannel(sChannel_t *ch, sChannelAggregate_t *out)
+{
+  if(0 == _count) {
+    memset(out, 0, sizeof(sChannelAggregate_t));
+    out->ema = _emaValid ? (uint16_t)((ch->ema + 0x80) >> 8) : 0;
+    return;
+  }
+  out->min = ch->min;
+  out->max = ch->max;
+  out->mean = (ch->sum + _count / 2) / _count;
+  out->median = ch->median;
+  out->ema = (uint16_t)((ch->ema + 0x80) >> 8);
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file  DFRobot_ENS160_Aggregator.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Aggregator class
+ * @details  Windowed aggregation of AQI, TVOC and eCO2 samples with fixed-point integer math and O(1) memory:
+ * @n        EMA, min, max, mean and an approximate median, one record at each window boundary.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_AGGREGATOR_H__
+#define __DFRobot_ENS160_AGGREGATOR_H__
+
+#include "DFRobot_ENS160.h"
+
+#define ENS160_AGG_WINDOW      60000   ///< Default window length, unit: ms
+#define ENS160_AGG_EMA_SHIFT   3   ///< Default EMA weight of a new sample: 1/2^3
+
+class DFRobot_ENS160_Aggregator
+{
+public:
+  /**
+   * @struct sChannelAggregate_t
+   * @brief Aggregate of one channel (AQI, TVOC or eCO2) over a window
+   */
+  typedef struct
+  {
+    uint16_t   min; /**< Minimum */
+    uint16_t   max; /**< Maximum */
+    uint16_t   mean; /**< Arithmetic mean */
+    uint16_t   median; /**< Approximate median of the window, tracked by a streaming estimator */
+    uint16_t   ema; /**< Exponential moving average at the end of the window, continues across windows */
+  } sChannelAggregate_t;
+
+  /**
+   * @struct sAggregate_t
+   * @brief Aggregate record emitted at a window boundary
+   */
+  typedef struct
+  {
+    uint32_t   start; /**< Window start, unit: ms */
+    uint32_t   length; /**< Window length, unit: ms */
+    uint16_t   count; /**< Number of samples aggregated */
+    uint16_t   skipped; /**< Number of samples skipped because of invalid output */
+    sChannelAggregate_t   AQI; /**< Air quality index */
+    sChannelAggregate_t   TVOC; /**< TVOC concentration, unit: ppb */
+    sChannelAggregate_t   ECO2; /**< CO2 equivalent concentration, unit: ppm */
+  } sAggregate_t;
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Aggregator
+   * @brief Constructor
+   * @param window Window length, unit: ms
+   * @param emaShift EMA weight of a new sample is 1/2^emaShift, range: 0-8
+   * @return None
+   */
+  DFRobot_ENS160_Aggregator(uint32_t window=ENS160_AGG_WINDOW, uint8_t emaShift=ENS160_AGG_EMA_SHIFT);
+
+  /**
+   * @fn update
+   * @brief Add a sample, samples with eInvalidOutput status are skipped
+   * @param sample The sample, e.g. from readSnapshot()
+   * @param timestamp Time of the sample, e.g. millis(), unit: ms
+   * @return true: the sample closed a window, the record can be got by getAggregate();
+   * @n      false: the window is still open
+   * @note The sample that closes a window belongs to the next window
+   */
+  bool update(const DFRobot_ENS160::sSnapshot_t &sample, uint32_t timestamp);
+
+  /**
+   * @fn update
+   * @brief Add a timestamped sample, e.g. from DFRobot_ENS160_SampleQueue
+   * @param sample The sample
+   * @return true: the sample closed a window; false: the window is still open
+   */
+  bool update(const DFRobot_ENS160::sTimedSnapshot_t &sample);
+
+  /**
+   * @fn getAggregate
+   * @brief Get the record of the last closed window
+   * @param aggregate Storage for the record
+   * @return None
+   */
+  void getAggregate(sAggregate_t *aggregate);
+
+  /**
+   * @fn getNextBoundary
+   * @brief Get the time the current window closes, the MCU can sleep until then
+   * @return Time, unit: ms
+   */
+  uint32_t getNextBoundary(void);
+
+  /**
+   * @fn reset
+   * @brief Drop the current window and the EMA, the next sample starts a new window
+   * @return None
+   */
+  void reset(void);
+
+private:
+  typedef struct
+  {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    int32_t ema;   // Q8 fixed point
+    uint16_t median;
+    uint16_t step;   // Step of the median estimator
+    int8_t dir;   // Direction of the last median step
+  } sChannel_t;
+
+  void startChannel(sChannel_t *ch, uint16_t value);
+  void addChannel(sChannel_t *ch, uint16_t value, bool first);
+  void closeChannel(sChannel_t *ch, sChannelAggregate_t *out);
+
+  uint32_t _window;
+  uint8_t _emaShift;
+  bool _started;   // A window is open
+  bool _emaValid;
+  uint32_t _start;
+  uint16_t _count;
+  uint16_t _skipped;
+  sChannel_t _AQI;
+  sChannel_t _TVOC;
+  sChannel_t _ECO2;
+  sAggregate_t _record;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*!
+ * @file DFRobot_ENS160_Benchmark.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Benchmark class
+ * @n Throughput, latency and bus cost of the driver's read paths, as CSV.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Benchmark.h"
+#include <stdio.h>
+
+static const char * const caseNames[DFRobot_ENS160_Benchmark::eBenchCaseNum] = {
+  "begin", "setPWRMode", "getENS160Status", "getAQI", "getTVOC", "getECO2",
+  "getters_sample", "readSnapshot", "readSnapshot_misr",
+};
+
+DFRobot_ENS160_Benchmark::DFRobot_ENS160_Benchmark(DFRobot_ENS160 *sensor, const sBenchMeter_t *meter, benchOutput_t output)
+{
+  _sensor = sensor;
+  _meter = meter;
+  _output = output;
+  _label = "ens160";
+}
+
+void DFRobot_ENS160_Benchmark::setLabel(const char *label)
+{
+  _label = label;
+}
+
+void DFRobot_ENS160_Benchmark::printHeader(void)
+{
+  _output("label,case,iterations,total_us,us_per_op,ops_per_s,transactions_per_op,wire_bytes_per_op");
+}
+
+void DFRobot_ENS160_Benchmark::run(uint16_t iterations)
+{
+  for(uint8_t i = 0; i < eBenchCaseNum; i++) {
+    runCase((eBenchCase_t)i, iterations);
+  }
+}
+
+const char *DFRobot_ENS160_Benchmark::getCaseName(eBenchCase_t benchCase)
+{
+  return (benchCase < eBenchCaseNum) ? caseNames[benchCase] : "unknown";
+}
+
+void DFRobot_ENS160_Benchmark::runCase(eBenchCase_t benchCase, uint16_t iterations)
+{
+  if((benchCase >= eBenchCaseNum) || (0 == iterations)) {
+    return;
+  }
+  if(((eBenchBegin == benchCase) || (eBenchSetPWRMode == benchCase)) && (iterations > ENS160_BENCH_SLOW_RUNS)) {
+    iterations = ENS160_BENCH_SLOW_RUNS;
+  }
+  if(eBenchSnapshotMISR == benchCase) {
+    _sensor->setMISRCheck(true);
+  }
+  runOnce(benchCase, 0);   // Warm-up, not measured: caches, bus driver, first-call effects
+
+  sBenchMeter_t start = {0, 0, 0};
+  if(NULL != _meter) {
+    start = *_meter;
+  }
+  uint32_t begin = micros();
+  for(uint16_t i = 0; i < iterations; i++) {
+    runOnce(benchCase, i + 1);
+  }
+  uint32_t totalTime = micros() - begin;
+  if(NULL != _meter) {
+    printResult(benchCase, iterations, totalTime, _meter->transactions - start.transactions,
+                _meter->wireBytes - start.wireBytes);
+  } else {
+    printResult(benchCase, iterations, totalTime, 0, 0);
+  }
+
+  if(eBenchSnapshotMISR == benchCase) {
+    _sensor->setMISRCheck(false);
+  } else if(eBenchSetPWRMode == benchCase) {
+    _sensor->setPWRMode(ENS160_STANDARD_MODE);   // Leave the sensor measuring for the next cases
+  }
+}
+
+void DFRobot_ENS160_Benchmark::runOnce(eBenchCase_t benchCase, uint16_t i)
+{
+  DFRobot_ENS160::sSnapshot_t snapshot;
+
+  switch(benchCase) {
+  case eBenchBegin:
+    _sensor->begin();
+    break;
+  case eBenchSetPWRMode:   // Alternate, setting the cached mode again would not touch the bus
+    _sensor->setPWRMode((i & 0x01) ? ENS160_IDLE_MODE : ENS160_STANDARD_MODE);
+    break;
+  case eBenchGetStatus:
+    _sensor->getENS160Status();
+    break;
+  case eBenchGetAQI:
+    _sensor->getAQI();
+    break;
+  case eBenchGetTVOC:
+    _sensor->getTVOC();
+    break;
+  case eBenchGetECO2:
+    _sensor->getECO2();
+    break;
+  case eBenchGetters:
+    _sensor->getENS160Status();
+    _sensor->getAQI();
+    _sensor->getTVOC();
+    _sensor->getECO2();
+    break;
+  default:
+    _sensor->readSnapshot(&snapshot);
+    break;
+  }
+}
+
+void DFRobot_ENS160_Benchmark::printResult(eBenchCase_t benchCase, uint16_t iterations, uint32_t totalTime,
+                                           uint32_t transactions, uint32_t wireBytes)
+{
+  char line[ENS160_BENCH_LINE_SIZE];
+  char *p = line;
+
+  // Fixed point by hand, printf() of AVR has no floating point support
+  int len = snprintf(line, ENS160_BENCH_LINE_SIZE - 64, "%s,%s,%u,%lu,", _label, getCaseName(benchCase),
+                     (unsigned)iterations, (unsigned long)totalTime);
+  p += (len < ENS160_BENCH_LINE_SIZE - 64) ? len : (ENS160_BENCH_LINE_SIZE - 65);   // A long label is cut
+  p = printFixed(p, totalTime, iterations);
+  *p++ = ',';
+  p = printFixed(p, (uint64_t)iterations * 1000000, totalTime ? totalTime : 1);
+  *p++ = ',';
+  if(NULL != _meter) {
+    p = printFixed(p, transactions, iterations);
+    *p++ = ',';
+    p = printFixed(p, wireBytes, iterations);
+  } else {
+    *p++ = ',';   // Not metered, leave the columns empty
+  }
+  *p = '\0';
+  _output(line);
+}
+
+char *DFRobot_ENS160_Benchmark::printFixed(char *p, uint64_t num, uint32_t den)
+{
+  uint64_t hundredths = (num * 100 + den / 2) / den;
+  return p + snprintf(p, 24, "%lu.%02u", (unsigned long)(hundredths / 100), (unsigned)(hundredths % 100));
+}
@@ -0,0 +1,188 @@
+/*!
+ * @file  DFRobot_ENS160_Benchmark.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Benchmark and DFRobot_ENS160_Metered classes
+ * @details  Measures what the read paths of the driver cost: time per getter call, samples per second,
+ * @n        bytes on the wire per sample and the time begin()/setPWRMode() block. One CSV line is output
+ * @n        per case, so that the results of library versions, buses, clocks and boards can be compared.
+ * @n        DFRobot_ENS160_Metered wraps any sensor class and counts its register transactions.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_BENCHMARK_H__
+#define __DFRobot_ENS160_BENCHMARK_H__
+
+#include "DFRobot_ENS160.h"
+
+#define ENS160_BENCH_SLOW_RUNS   5   ///< Runs of the blocking cases (begin, setPWRMode), each takes tens of ms
+#define ENS160_BENCH_LINE_SIZE   128   ///< Longest CSV line
+
+/* Bytes a register transaction puts on the wire besides the data */
+#define ENS160_BENCH_I2C_READ_OVERHEAD    3   ///< Address(W), register address, address(R)
+#define ENS160_BENCH_I2C_WRITE_OVERHEAD   2   ///< Address(W), register address
+#define ENS160_BENCH_SPI_OVERHEAD         1   ///< Register address byte
+
+class DFRobot_ENS160_Benchmark
+{
+public:
+  /**
+   * @struct sBenchMeter_t
+   * @brief Register transaction counters, kept by DFRobot_ENS160_Metered
+   */
+  typedef struct
+  {
+    uint32_t   transactions; /**< readReg() and writeReg() calls */
+    uint32_t   bytes; /**< Data bytes read and written */
+    uint32_t   wireBytes; /**< Bytes on the wire, including the protocol overhead */
+  } sBenchMeter_t;
+
+  /**
+   * @enum eBenchCase_t
+   * @brief Measured operations
+   */
+  typedef enum
+  {
+    eBenchBegin = 0,   /**< begin(), blocking */
+    eBenchSetPWRMode,   /**< setPWRMode() alternating IDLE and STANDARD, blocking */
+    eBenchGetStatus,   /**< getENS160Status() */
+    eBenchGetAQI,   /**< getAQI() */
+    eBenchGetTVOC,   /**< getTVOC() */
+    eBenchGetECO2,   /**< getECO2() */
+    eBenchGetters,   /**< One sample with the four getters above */
+    eBenchSnapshot,   /**< One sample with readSnapshot() */
+    eBenchSnapshotMISR,   /**< One sample with readSnapshot() and the MISR check */
+    eBenchCaseNum,
+  }eBenchCase_t;
+
+  /**
+   * @fn benchOutput_t
+   * @brief Receives one CSV line, without line end
+   */
+  typedef void (*benchOutput_t)(const char *line);
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Benchmark
+   * @brief Constructor
+   * @param sensor The sensor to measure
+   * @param meter Its transaction counters (see DFRobot_ENS160_Metered::getMeter()), NULL if not metered
+   * @param output Function that prints a CSV line
+   * @return None
+   */
+  DFRobot_ENS160_Benchmark(DFRobot_ENS160 *sensor, const sBenchMeter_t *meter, benchOutput_t output);
+
+  /**
+   * @fn setLabel
+   * @brief Set the first column of every line, e.g. the library version, board and bus clock
+   * @param label The label, must not contain commas, the string is not copied
+   * @return None
+   */
+  void setLabel(const char *label);
+
+  /**
+   * @fn printHeader
+   * @brief Output the CSV column names:
+   * @n     label,case,iterations,total_us,us_per_op,ops_per_s,transactions_per_op,wire_bytes_per_op
+   * @return None
+   */
+  void printHeader(void);
+
+  /**
+   * @fn run
+   * @brief Measure all cases and output one line per case
+   * @param iterations Operations per case, the blocking cases run ENS160_BENCH_SLOW_RUNS times at most
+   * @return None
+   */
+  void run(uint16_t iterations);
+
+  /**
+   * @fn runCase
+   * @brief Measure one case and output its line
+   * @param benchCase The case
+   * @param iterations Operations to measure
+   * @return None
+   */
+  void runCase(eBenchCase_t benchCase, uint16_t iterations);
+
+  /**
+   * @fn getCaseName
+   * @brief The name of a case in the CSV output
+   * @param benchCase The case
+   * @return Name, e.g. "getAQI"
+   */
+  static const char *getCaseName(eBenchCase_t benchCase);
+
+private:
+  void runOnce(eBenchCase_t benchCase, uint16_t i);
+  void printResult(eBenchCase_t benchCase, uint16_t iterations, uint32_t totalTime,
+                   uint32_t transactions, uint32_t wireBytes);
+  static char *printFixed(char *p, uint64_t num, uint32_t den);
+
+  DFRobot_ENS160 *_sensor;
+  const sBenchMeter_t *_meter;
+  benchOutput_t _output;
+  const char *_label;
+};
+
+/**
+ * @brief Any sensor class with its register transactions counted
+ * @param Sensor DFRobot_ENS160_I2C, DFRobot_ENS160_SPI, DFRobot_ENS160_Sim, DFRobot_ENS160_LinuxI2C ...
+ * @n     The constructor takes the same arguments as the one of Sensor.
+ */
+template <class Sensor>
+class DFRobot_ENS160_Metered:public Sensor
+{
+public:
+  using Sensor::Sensor;
+
+  /**
+   * @fn setWireOverhead
+   * @brief Set the bytes a transaction puts on the wire besides the data, the default is the I2C overhead
+   * @param readOverhead Overhead of a read, ENS160_BENCH_I2C_READ_OVERHEAD or ENS160_BENCH_SPI_OVERHEAD
+   * @param writeOverhead Overhead of a write, ENS160_BENCH_I2C_WRITE_OVERHEAD or ENS160_BENCH_SPI_OVERHEAD
+   * @return None
+   */
+  void setWireOverhead(uint8_t readOverhead, uint8_t writeOverhead)
+  {
+    _readOverhead = readOverhead;
+    _writeOverhead = writeOverhead;
+  }
+
+  /**
+   * @fn getMeter
+   * @brief The counters, pass them to DFRobot_ENS160_Benchmark
+   * @return The counters
+   */
+  const DFRobot_ENS160_Benchmark::sBenchMeter_t *getMeter(void)
+  {
+    return &_meter;
+  }
+
+protected:
+  virtual void writeReg(uint8_t reg, const void* pBuf, size_t size)
+  {
+    Sensor::writeReg(reg, pBuf, size);
+    _meter.transactions++;
+    _meter.bytes += size;
+    _meter.wireBytes += _writeOverhead + size;
+  }
+
+  virtual size_t readReg(uint8_t reg, void* pBuf, size_t size)
+  {
+    size_t count = Sensor::readReg(reg, pBuf, size);
+    _meter.transactions++;
+    _meter.bytes += count;
+    _meter.wireBytes += _readOverhead + size;   // The clock runs for the requested bytes even if the read fails
+    return count;
+  }
+
+private:
+  DFRobot_ENS160_Benchmark::sBenchMeter_t _meter = {0, 0, 0};
+  uint8_t _readOverhead = ENS160_BENCH_I2C_READ_OVERHEAD;
+  uint8_t _writeOverhead = ENS160_BENCH_I2C_WRITE_OVERHEAD;
+};
+
+#endif
@@ -0,0 +1,336 @@
+/*!
+ * @file  DFRobot_ENS160_Bus.h
+ * @brief  Define the I2C and SPI bus access of the ENS160
+ * @details  DFRobot_ENS160_I2CBus and DFRobot_ENS160_SPIBus implement the register read/write of the sensor
+ * @n        with non-virtual inline functions. They are used by DFRobot_ENS160_I2C and DFRobot_ENS160_SPI,
+ * @n        and as the Bus parameter of the DFRobot_ENS160_Fast template driver.
+ * @n        This file is included by DFRobot_ENS160.h.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_BUS_H__
+#define __DFRobot_ENS160_BUS_H__
+
+#if defined(I2C_BUFFER_LENGTH)
+  #define ENS160_I2C_BUFFER_SIZE   I2C_BUFFER_LENGTH   ///< Wire buffer size of the platform (ESP32)
+#elif defined(BUFFER_LENGTH)
+  #define ENS160_I2C_BUFFER_SIZE   BUFFER_LENGTH   ///< Wire buffer size of the platform (AVR, ESP8266)
+#else
+  #define ENS160_I2C_BUFFER_SIZE   32   ///< Smallest Wire buffer size of the common platforms
+#endif
+#define ENS160_I2C_RETRIES     2   ///< Default number of retries of a NACKed or short I2C transfer
+#define ENS160_PIN_NONE        0xFF   ///< No pin assigned
+
+#define ENS160_SPI_CLOCK       2000000   ///< Default SPI clock, unit: Hz
+#define ENS160_SPI_MAX_CLOCK   10000000   ///< Maximum SPI clock of the ENS160, unit: Hz
+#define ENS160_SPI_CHUNK       8   ///< Bytes written per buffer transfer (GPR_WRITE is the largest register block)
+
+class DFRobot_ENS160_I2CBus
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_I2CBus
+   * @brief Constructor, set sensor I2C communication address according to SDO pin wiring
+   * @param pWire Wire object is defined in Wire.h, so just use &Wire and the methods in Wire can be pointed to and used
+   * @param i2cAddr The I2C address is 0x52 when SDO pin is connected to GND and 0x53 when connected to VCC.
+   * @return None
+   */
+  DFRobot_ENS160_I2CBus(TwoWire *pWire=&Wire, uint8_t i2cAddr=0x52)
+  {
+    _pWire = pWire;
+    _deviceAddr = i2cAddr;
+    _retries = ENS160_I2C_RETRIES;
+    _sdaPin = ENS160_PIN_NONE;
+    _sclPin = ENS160_PIN_NONE;
+  }
+
+  /**
+   * @fn begin
+   * @brief Init the I2C bus
+   * @return None
+   */
+  void begin(void)
+  {
+    _pWire->begin();   // Wire.h(I2C)library function initialize wire library
+  }
+
+  /**
+   * @fn setRetries
+   * @brief Set how many times a NACKed or short transfer is repeated before it fails
+   * @param retries Number of retries, 0 means no retry
+   * @return None
+   */
+  void setRetries(uint8_t retries)
+  {
+    _retries = retries;
+  }
+
+  /**
+   * @fn setRecoveryPins
+   * @brief Set the SDA and SCL pins used by recoverBus(), a failed transfer then recovers the bus automatically
+   * @param sdaPin SDA pin number, ENS160_PIN_NONE disables the recovery
+   * @param sclPin SCL pin number, ENS160_PIN_NONE disables the recovery
+   * @return None
+   */
+  void setRecoveryPins(uint8_t sdaPin, uint8_t sclPin)
+  {
+    _sdaPin = sdaPin;
+    _sclPin = sclPin;
+  }
+
+  /**
+   * @fn recoverBus
+   * @brief Free a bus held by a slave stuck in the middle of a byte: clock SCL until SDA is released,
+   * @n     generate a STOP condition and init the Wire library again
+   * @return true: SDA is released; false: no recovery pins or SDA is still held low
+   */
+  bool recoverBus(void)
+  {
+    if((ENS160_PIN_NONE == _sdaPin) || (ENS160_PIN_NONE == _sclPin)) {
+      return false;
+    }
+    pinMode(_sdaPin, INPUT_PULLUP);
+    pinMode(_sclPin, INPUT_PULLUP);
+    for(uint8_t i = 0; (i < 9) && (LOW == digitalRead(_sdaPin)); i++) {
+      pinMode(_sclPin, OUTPUT);   // Open-drain low
+      digitalWrite(_sclPin, LOW);
+      delayMicroseconds(5);
+      pinMode(_sclPin, INPUT_PULLUP);
+      delayMicroseconds(5);
+    }
+    bool released = (HIGH == digitalRead(_sdaPin));
+    pinMode(_sdaPin, OUTPUT);   // STOP: SDA rises while SCL is high
+    digitalWrite(_sdaPin, LOW);
+    delayMicroseconds(5);
+    pinMode(_sdaPin, INPUT_PULLUP);
+    delayMicroseconds(5);
+    DBG("bus recovered:");DBG(released);
+    _pWire->begin();
+    return released;
+  }
+
+  /**
+   * @fn writeReg
+   * @brief Write register value through I2C bus, in chunks that fit the Wire buffer
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be written
+   * @param size Length of data to be written
+   * @return true: success; false: the sensor did not acknowledge
+   */
+  bool writeReg(uint8_t reg, const void* pBuf, size_t size)
+  {
+    if(pBuf == NULL) {
+      DBG("pBuf ERROR!! : null pointer");
+      return false;
+    }
+    const uint8_t * _pBuf = (const uint8_t *)pBuf;
+
+    do {
+      size_t n = (size > (ENS160_I2C_BUFFER_SIZE - 1)) ? (ENS160_I2C_BUFFER_SIZE - 1) : size;   // One byte for reg
+      uint8_t attempt = 0;
+      while(!writeChunk(reg, _pBuf, n)) {
+        if(attempt++ >= _retries) {
+          recoverBus();
+          return false;
+        }
+      }
+      reg += n;   // The register address auto-increments
+      _pBuf += n;
+      size -= n;
+    } while(size);
+    return true;
+  }
+
+  /**
+   * @fn readReg
+   * @brief Read register value through I2C bus, register address and data are joined by a repeated start
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be read
+   * @param size Length of data to be read
+   * @return Return the read length, returning 0 means reading failed
+   */
+  size_t readReg(uint8_t reg, void* pBuf, size_t size)
+  {
+    if(NULL == pBuf) {
+      DBG("pBuf ERROR!! : null pointer");
+      return 0;
+    }
+    uint8_t * _pBuf = (uint8_t*)pBuf;
+    size_t count = 0;
+
+    while(count < size) {
+      size_t n = size - count;
+      if(n > ENS160_I2C_BUFFER_SIZE) {
+        n = ENS160_I2C_BUFFER_SIZE;
+      }
+      uint8_t attempt = 0;
+      while(!readChunk(reg + count, &_pBuf[count], n)) {
+        if(attempt++ >= _retries) {
+          recoverBus();
+          return count;
+        }
+      }
+      count += n;
+    }
+    return count;
+  }
+
+private:
+  bool writeChunk(uint8_t reg, const uint8_t *pBuf, size_t size)
+  {
+    _pWire->beginTransmission(_deviceAddr);
+    _pWire->write(reg);
+    for(size_t i = 0; i < size; i++) {
+      _pWire->write(pBuf[i]);
+    }
+    if(0 != _pWire->endTransmission()) {
+      DBG("endTransmission ERROR!!");
+      return false;
+    }
+    return true;
+  }
+
+  bool readChunk(uint8_t reg, uint8_t *pBuf, size_t size)
+  {
+    _pWire->beginTransmission(_deviceAddr);
+    _pWire->write(reg);
+    uint8_t ret = _pWire->endTransmission(false);   // No STOP, the read follows with a repeated start
+#if defined(ESP32)
+    if(7 == ret) {   // ESP32 core 1.0.x reports I2C_ERROR_CONTINUE for a transfer without STOP
+      ret = 0;
+    }
+#endif
+    if(0 != ret) {
+      DBG("endTransmission ERROR!!");
+      return false;
+    }
+    if(size != _pWire->requestFrom(_deviceAddr, (uint8_t)size)) {
+      DBG("requestFrom ERROR!!");
+      while(_pWire->available()) {   // Drop the partial data
+        _pWire->read();
+      }
+      return false;
+    }
+    for(size_t i = 0; i < size; i++) {   // Never more than requested
+      pBuf[i] = _pWire->read();
+    }
+    return true;
+  }
+
+  TwoWire *_pWire;   // Pointer to I2C communication method
+  uint8_t _deviceAddr;   // Address of the device for I2C communication
+  uint8_t _retries;   // Retries of a failed transfer
+  uint8_t _sdaPin;   // Pins for bus recovery
+  uint8_t _sclPin;
+};
+
+class DFRobot_ENS160_SPIBus
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_SPIBus
+   * @brief Constructor
+   * @param pSpi extern SPIClass SPI is defined in SPI.h; so just get SPI object address and the methods in SPI can be pointed to and used
+   * @param csPin The digital pin that only cs pin can connect to
+   * @param clock SPI clock, unit: Hz, limited to ENS160_SPI_MAX_CLOCK
+   * @return None
+   */
+  DFRobot_ENS160_SPIBus(SPIClass *pSpi, uint8_t csPin, uint32_t clock=ENS160_SPI_CLOCK)
+  {
+    _pSpi = pSpi;
+    _csPin = csPin;
+    setClock(clock);
+  }
+
+  /**
+   * @fn begin
+   * @brief Init the SPI bus and the cs pin
+   * @return None
+   */
+  void begin(void)
+  {
+    pinMode(_csPin, OUTPUT);
+    digitalWrite(_csPin,HIGH);
+    _pSpi->begin();
+  }
+
+  /**
+   * @fn setClock
+   * @brief Set the SPI clock
+   * @param clock SPI clock, unit: Hz, limited to ENS160_SPI_MAX_CLOCK
+   * @return None
+   */
+  void setClock(uint32_t clock)
+  {
+    _clock = (clock > ENS160_SPI_MAX_CLOCK) ? ENS160_SPI_MAX_CLOCK : clock;
+  }
+
+  /**
+   * @fn writeReg
+   * @brief Write register value through SPI bus
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be written
+   * @param size Length of data to be written
+   * @return true: success (SPI has no acknowledge, so always true)
+   */
+  bool writeReg(uint8_t reg, const void* pBuf, size_t size)
+  {
+    if(NULL == pBuf) {
+      DBG("pBuf ERROR!! : null pointer");
+      return false;
+    }
+    const uint8_t * _pBuf = (const uint8_t *)pBuf;
+    uint8_t chunk[ENS160_SPI_CHUNK];   // transfer(buf, n) overwrites buf with the received bytes
+
+    _pSpi->beginTransaction(SPISettings(_clock, MSBFIRST, SPI_MODE0));
+    digitalWrite(_csPin, LOW);
+    _pSpi->transfer((reg << 1) & 0xFE);
+    while(size) {
+      size_t n = (size > sizeof(chunk)) ? sizeof(chunk) : size;
+      memcpy(chunk, _pBuf, n);
+      _pSpi->transfer(chunk, n);
+      _pBuf += n;
+      size -= n;
+    }
+    digitalWrite(_csPin, HIGH);
+    _pSpi->endTransaction();
+    return true;
+  }
+
+  /**
+   * @fn readReg
+   * @brief Read register value through SPI bus
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be read
+   * @param size Length of data to be read
+   * @return Return the read length, returning 0 means reading failed
+   */
+  size_t readReg(uint8_t reg, void* pBuf, size_t size)
+  {
+    if(NULL == pBuf) {
+      DBG("pBuf ERROR!! : null pointer");
+      return 0;
+    }
+
+    memset(pBuf, 0x00, size);   // Dummy bytes clocked out while reading
+    _pSpi->beginTransaction(SPISettings(_clock, MSBFIRST, SPI_MODE0));
+    digitalWrite(_csPin, LOW);
+    _pSpi->transfer((reg << 1) | 0x01);
+    _pSpi->transfer(pBuf, size);
+    digitalWrite(_csPin, HIGH);   // Release cs before the bus can be handed to another device
+    _pSpi->endTransaction();
+
+    return size;
+  }
+
+private:
+  SPIClass *_pSpi;   // Pointer to SPI communication method
+  uint8_t _csPin;   // Cs pin of SPI communication
+  uint32_t _clock;   // SPI clock
+};
+
+#endif
@@ -0,0 +1,237 @@
+/*!
+ * @file DFRobot_ENS160_Codec.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Encoder and DFRobot_ENS160_Decoder classes
+ * @n Delta and zig-zag varint encoding of sample sequences.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Codec.h"
+#include <string.h>
+
+/* Record mask bits: which fields follow */
+#define MASK_TIMESTAMP   0x01
+#define MASK_STATUS      0x02
+#define MASK_AQI         0x04
+#define MASK_TVOC        0x08
+#define MASK_ECO2        0x10
+#define MASK_TEMP        0x20
+#define MASK_HUM         0x40
+
+static uint32_t zigzag(int32_t value)
+{
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static size_t putVarint(uint8_t *buf, uint32_t value)
+{
+  size_t n = 0;
+  while(value >= 0x80) {
+    buf[n++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  buf[n++] = (uint8_t)value;
+  return n;
+}
+
+static bool getVarint(const uint8_t *buf, size_t len, size_t *pos, uint32_t *value)
+{
+  uint32_t result = 0;
+  for(uint8_t shift = 0; shift < 35; shift += 7) {
+    if(*pos >= len) {
+      return false;
+    }
+    uint8_t byte = buf[(*pos)++];
+    result |= (uint32_t)(byte & 0x7F) << shift;
+    if(0 == (byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+/***************** Encoder ******************************/
+
+DFRobot_ENS160_Encoder::DFRobot_ENS160_Encoder(void)
+{
+  _buf = NULL;
+  _size = 0;
+  _len = 0;
+  _flags = 0;
+}
+
+bool DFRobot_ENS160_Encoder::begin(uint8_t *buf, size_t size, uint8_t flags)
+{
+  if((NULL == buf) || (size < ENS160_CODEC_HEADER_SIZE)) {
+    _buf = NULL;
+    return false;
+  }
+  _buf = buf;
+  _size = size;
+  _flags = flags;
+  _buf[0] = ENS160_CODEC_VERSION;
+  _buf[1] = flags;
+  _buf[2] = 0;   // Number of samples
+  _len = ENS160_CODEC_HEADER_SIZE;
+  memset(&_prev, 0, sizeof(_prev));   // The first sample is a delta against zero
+  _prevDelta = 0;
+  return true;
+}
+
+bool DFRobot_ENS160_Encoder::add(const sCodecSample_t &sample)
+{
+  uint8_t record[ENS160_CODEC_MAX_RECORD];
+  size_t n = 1;
+  uint8_t mask = 0;
+
+  if((NULL == _buf) || (ENS160_CODEC_MAX_SAMPLES == _buf[2])) {
+    return false;
+  }
+
+  uint32_t delta = sample.timestamp - _prev.timestamp;
+  int32_t dod = (int32_t)(delta - _prevDelta);   // Steady rate: delta of delta is 0
+  if(dod) {
+    mask |= MASK_TIMESTAMP;
+    n += putVarint(&record[n], zigzag(dod));
+  }
+  if(sample.status != _prev.status) {
+    mask |= MASK_STATUS;
+    n += putVarint(&record[n], zigzag((int32_t)sample.status - _prev.status));
+  }
+  if(sample.AQI != _prev.AQI) {
+    mask |= MASK_AQI;
+    n += putVarint(&record[n], zigzag((int32_t)sample.AQI - _prev.AQI));
+  }
+  if(sample.TVOC != _prev.TVOC) {
+    mask |= MASK_TVOC;
+    n += putVarint(&record[n], zigzag((int32_t)sample.TVOC - _prev.TVOC));
+  }
+  if(sample.ECO2 != _prev.ECO2) {
+    mask |= MASK_ECO2;
+    n += putVarint(&record[n], zigzag((int32_t)sample.ECO2 - _prev.ECO2));
+  }
+  if(_flags & ENS160_CODEC_TEMP_HUM) {
+    if(sample.temp != _prev.temp) {
+      mask |= MASK_TEMP;
+      n += putVarint(&record[n], zigzag((int32_t)sample.temp - _prev.temp));
+    }
+    if(sample.hum != _prev.hum) {
+      mask |= MASK_HUM;
+      n += putVarint(&record[n], zigzag((int32_t)sample.hum - _prev.hum));
+    }
+  }
+  record[0] = mask;
+
+  if(_len + n > _size) {
+    return false;
+  }
+  memcpy(&_buf[_len], record, n);
+  _len += n;
+  _buf[2]++;
+  _prev = sample;
+  _prevDelta = delta;
+  return true;
+}
+
+size_t DFRobot_ENS160_Encoder::getLength(void)
+{
+  return _len;
+}
+
+uint8_t DFRobot_ENS160_Encoder::getCount(void)
+{
+  return _buf ? _buf[2] : 0;
+}
+
+/***************** Decoder ******************************/
+
+DFRobot_ENS160_Decoder::DFRobot_ENS160_Decoder(void)
+{
+  _buf = NULL;
+  _len = 0;
+  _pos = 0;
+  _index = 0;
+}
+
+bool DFRobot_ENS160_Decoder::begin(const uint8_t *buf, size_t len)
+{
+  if((NULL == buf) || (len < ENS160_CODEC_HEADER_SIZE) || (ENS160_CODEC_VERSION != buf[0])) {
+    _buf = NULL;
+    return false;
+  }
+  _buf = buf;
+  _len = len;
+  _pos = ENS160_CODEC_HEADER_SIZE;
+  _index = 0;
+  memset(&_prev, 0, sizeof(_prev));
+  _prevDelta = 0;
+  return true;
+}
+
+uint8_t DFRobot_ENS160_Decoder::getCount(void)
+{
+  return _buf ? _buf[2] : 0;
+}
+
+uint8_t DFRobot_ENS160_Decoder::getFlags(void)
+{
+  return _buf ? _buf[1] : 0;
+}
+
+bool DFRobot_ENS160_Decoder::next(sCodecSample_t *sample)
+{
+  uint32_t value;
+  if((NULL == _buf) || (NULL == sample) || (_index >= _buf[2]) || (_pos >= _len)) {
+    return false;
+  }
+  size_t pos = _pos;
+  uint8_t mask = _buf[pos++];
+  sCodecSample_t s = _prev;
+  uint32_t delta = _prevDelta;
+
+  if(mask & MASK_TIMESTAMP) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    delta += unzigzag(value);
+  }
+  s.timestamp = _prev.timestamp + delta;
+  if(mask & MASK_STATUS) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    s.status += unzigzag(value);
+  }
+  if(mask & MASK_AQI) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    s.AQI += unzigzag(value);
+  }
+  if(mask & MASK_TVOC) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    s.TVOC += unzigzag(value);
+  }
+  if(mask & MASK_ECO2) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    s.ECO2 += unzigzag(value);
+  }
+  if(mask & MASK_TEMP) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    s.temp += unzigzag(value);
+  }
+  if(mask & MASK_HUM) {
+    if(!getVarint(_buf, _len, &pos, &value)) return false;
+    s.hum += unzigzag(value);
+  }
+
+  *sample = s;
+  _prev = s;
+  _prevDelta = delta;
+  _pos = pos;
+  _index++;
+  return true;
+}
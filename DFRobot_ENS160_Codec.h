@@ -0,0 +1,145 @@
+/*!
+ * @file  DFRobot_ENS160_Codec.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Encoder and DFRobot_ENS160_Decoder classes
+ * @details  Compact binary encoding of sample sequences for logging and low-rate radio links.
+ * @n        A block is a 3-byte header followed by one record per sample. Each record starts with a
+ * @n        mask byte telling which fields changed, followed by the zig-zag varint delta of those fields
+ * @n        (delta-of-delta for the timestamp), so an unchanged sample at a steady rate costs one byte.
+ * @n        Both classes only write into or read from caller buffers, no heap is used.
+ * @n        This file does not depend on the Arduino core, the decoder also builds on a host.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_CODEC_H__
+#define __DFRobot_ENS160_CODEC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ENS160_CODEC_VERSION       uint8_t(0xE1)   ///< First byte of a block: format version
+#define ENS160_CODEC_HEADER_SIZE   3   ///< Version, flags, number of samples
+#define ENS160_CODEC_MAX_RECORD    36   ///< Largest record: mask byte and 7 varints of up to 5 bytes
+#define ENS160_CODEC_MAX_SAMPLES   255   ///< Samples per block
+#define ENS160_CODEC_TEMP_HUM      uint8_t(0x01)   ///< Header flag: the block carries temperature and humidity
+
+/**
+ * @struct sCodecSample_t
+ * @brief One sample as encoded by DFRobot_ENS160_Encoder
+ */
+typedef struct
+{
+  uint32_t   timestamp; /**< Time of the sample, unit: ms */
+  uint8_t   status; /**< DATA_STATUS register */
+  uint8_t   AQI; /**< Air quality index */
+  uint16_t   TVOC; /**< TVOC concentration, unit: ppb */
+  uint16_t   ECO2; /**< CO2 equivalent concentration, unit: ppm */
+  int16_t   temp; /**< Ambient temperature, unit: 0.01 C (only with ENS160_CODEC_TEMP_HUM) */
+  uint16_t   hum; /**< Ambient humidity, unit: 0.01 %rH (only with ENS160_CODEC_TEMP_HUM) */
+} sCodecSample_t;
+
+class DFRobot_ENS160_Encoder
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_Encoder
+   * @brief Constructor
+   * @return None
+   */
+  DFRobot_ENS160_Encoder(void);
+
+  /**
+   * @fn begin
+   * @brief Start a new block in the caller buffer
+   * @param buf Buffer the block is written to
+   * @param size Size of buf, at least ENS160_CODEC_HEADER_SIZE + ENS160_CODEC_MAX_RECORD is recommended
+   * @param flags 0 or ENS160_CODEC_TEMP_HUM
+   * @return true: success; false: buf is too small for the header
+   */
+  bool begin(uint8_t *buf, size_t size, uint8_t flags);
+
+  /**
+   * @fn add
+   * @brief Append a sample to the block
+   * @param sample The sample, timestamps must not decrease
+   * @return true: the sample was added; false: the block is full, start a new one with begin()
+   */
+  bool add(const sCodecSample_t &sample);
+
+  /**
+   * @fn getLength
+   * @brief Get the number of bytes of the block written so far
+   * @return Block length
+   */
+  size_t getLength(void);
+
+  /**
+   * @fn getCount
+   * @brief Get the number of samples in the block
+   * @return Number of samples
+   */
+  uint8_t getCount(void);
+
+private:
+  uint8_t *_buf;
+  size_t _size;
+  size_t _len;
+  uint8_t _flags;
+  sCodecSample_t _prev;
+  uint32_t _prevDelta;   // Previous timestamp delta
+};
+
+class DFRobot_ENS160_Decoder
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_Decoder
+   * @brief Constructor
+   * @return None
+   */
+  DFRobot_ENS160_Decoder(void);
+
+  /**
+   * @fn begin
+   * @brief Start decoding a block
+   * @param buf The block
+   * @param len Length of the block
+   * @return true: the header is valid; false: not a block of this version
+   */
+  bool begin(const uint8_t *buf, size_t len);
+
+  /**
+   * @fn getCount
+   * @brief Get the number of samples in the block
+   * @return Number of samples
+   */
+  uint8_t getCount(void);
+
+  /**
+   * @fn getFlags
+   * @brief Get the header flags of the block
+   * @return 0 or ENS160_CODEC_TEMP_HUM
+   */
+  uint8_t getFlags(void);
+
+  /**
+   * @fn next
+   * @brief Decode the next sample
+   * @param sample Storage for the sample
+   * @return true: success; false: no more samples or the block is truncated
+   */
+  bool next(sCodecSample_t *sample);
+
+private:
+  const uint8_t *_buf;
+  size_t _len;
+  size_t _pos;
+  uint8_t _index;
+  sCodecSample_t _prev;
+  uint32_t _prevDelta;
+};
+
+#endif
@@ -0,0 +1,245 @@
+/*!
+ * @file DFRobot_ENS160_Events.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Events class
+ * @n Threshold and rate-of-change events on the samples.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Events.h"
+
+DFRobot_ENS160_Events::DFRobot_ENS160_Events(void)
+{
+  _count = 0;
+  _validOnly = true;
+  _callback = NULL;
+  _wake = false;
+  _head = 0;
+  _queued = 0;
+  _dropped = 0;
+}
+
+void DFRobot_ENS160_Events::attach(DFRobot_ENS160 *sensor)
+{
+  sensor->setSampleCallback(onSample, this);
+}
+
+void DFRobot_ENS160_Events::onSample(const DFRobot_ENS160::sSnapshot_t *snapshot, void *arg)
+{
+  ((DFRobot_ENS160_Events *)arg)->update(*snapshot, millis());
+}
+
+int DFRobot_ENS160_Events::addLevels(eChannel_t channel, const uint16_t *levels, uint8_t num, uint16_t hysteresis, uint8_t confirm)
+{
+  sRule_t rule;
+  if((NULL == levels) || (0 == num) || (ENS160_EVENT_MAX_LEVELS < num)) {
+    DBG("levels ERROR!! : null pointer or bad number");
+    return -1;
+  }
+  memset(&rule, 0, sizeof(rule));
+  rule.channel = channel;
+  rule.num = num;
+  memcpy(rule.levels, levels, num * sizeof(uint16_t));
+  rule.hysteresis = hysteresis;
+  rule.confirm = confirm ? confirm : 1;
+  return addRule(rule);
+}
+
+int DFRobot_ENS160_Events::addAQIBand(uint8_t confirm)
+{
+  const uint16_t bands[] = {2, 3, 4, 5};
+  return addLevels(eChannelAQI, bands, 4, 0, confirm);
+}
+
+int DFRobot_ENS160_Events::addECO2Levels(uint16_t hysteresis)
+{
+  const uint16_t levels[] = {600, 800, 1000, 1500};   // Good, moderate, poor, unhealthy
+  return addLevels(eChannelECO2, levels, 4, hysteresis);
+}
+
+int DFRobot_ENS160_Events::addRateLimit(eChannel_t channel, uint16_t limit, uint16_t hysteresis, uint32_t window)
+{
+  sRule_t rule;
+  if((0 == limit) || (hysteresis >= limit) || (0 == window)) {
+    DBG("rate ERROR!! : bad limit or window");
+    return -1;
+  }
+  memset(&rule, 0, sizeof(rule));
+  rule.rate = true;
+  rule.channel = channel;
+  rule.levels[0] = limit;
+  rule.hysteresis = hysteresis;
+  rule.window = window;
+  return addRule(rule);
+}
+
+int DFRobot_ENS160_Events::addRule(const sRule_t &rule)
+{
+  if(ENS160_EVENT_MAX_RULES <= _count) {
+    DBG("rule ERROR!! : engine full");
+    return -1;
+  }
+  _rules[_count] = rule;
+  return _count++;
+}
+
+void DFRobot_ENS160_Events::setEventCallback(eventCallback_t callback)
+{
+  _callback = callback;
+}
+
+void DFRobot_ENS160_Events::setValidOnly(bool validOnly)
+{
+  _validOnly = validOnly;
+}
+
+bool DFRobot_ENS160_Events::update(const DFRobot_ENS160::sSnapshot_t &sample, uint32_t timestamp)
+{
+  uint8_t validity = sample.status.validityFlag;
+  if((DFRobot_ENS160::eInvalidOutput == validity) ||
+     (_validOnly && (DFRobot_ENS160::eNormalOperation != validity))) {
+    return false;
+  }
+
+  bool fired = false;
+  for(uint8_t i = 0; i < _count; i++) {
+    uint16_t value;
+    switch(_rules[i].channel) {
+    case eChannelAQI:
+      value = sample.AQI;
+      break;
+    case eChannelTVOC:
+      value = sample.TVOC;
+      break;
+    default:
+      value = sample.ECO2;
+      break;
+    }
+    if(checkRule(i, value, timestamp)) {
+      fired = true;
+    }
+  }
+  return fired;
+}
+
+bool DFRobot_ENS160_Events::checkRule(uint8_t index, uint16_t value, uint32_t timestamp)
+{
+  sRule_t &rule = _rules[index];
+  uint8_t from = rule.state;
+
+  if(!rule.rate) {
+    uint8_t level = rule.state;
+    while((level < rule.num) && (value >= rule.levels[level])) {
+      level++;
+    }
+    while((level > 0) && ((uint32_t)value + rule.hysteresis < rule.levels[level - 1])) {
+      level--;
+    }
+    if(!rule.primed) {   // The first sample sets the level without an event
+      rule.primed = true;
+      rule.state = level;
+      return false;
+    }
+    if(from == level) {
+      rule.pending = 0;
+      return false;
+    }
+    if(rule.pending && (rule.candidate == level)) {
+      rule.pending++;
+    } else {
+      rule.candidate = level;
+      rule.pending = 1;
+    }
+    if(rule.pending < rule.confirm) {
+      return false;
+    }
+    rule.pending = 0;
+    rule.state = level;
+    fire(index, from, value, timestamp);
+    return true;
+  }
+
+  if(!rule.primed) {
+    rule.primed = true;
+    rule.refValue = value;
+    rule.refTime = timestamp;
+    return false;
+  }
+  uint32_t elapsed = timestamp - rule.refTime;
+  if(elapsed < rule.window) {
+    return false;
+  }
+  int32_t rate = (int32_t)(((int64_t)value - rule.refValue) * 60000 / (int64_t)elapsed);
+  rule.refValue = value;   // This sample starts the next window
+  rule.refTime = timestamp;
+
+  int32_t limit = rule.levels[0];
+  int32_t release = limit - rule.hysteresis;
+  if(rate >= limit) {
+    rule.state = eRateRising;
+  } else if(rate <= -limit) {
+    rule.state = eRateFalling;
+  } else if(((eRateRising == rule.state) && (rate < release)) ||
+            ((eRateFalling == rule.state) && (rate > -release))) {
+    rule.state = eRateSteady;
+  }
+  if(from == rule.state) {
+    return false;
+  }
+  fire(index, from, rate, timestamp);
+  return true;
+}
+
+void DFRobot_ENS160_Events::fire(uint8_t index, uint8_t from, int32_t value, uint32_t timestamp)
+{
+  sEvent_t event;
+  event.timestamp = timestamp;
+  event.value = value;
+  event.rule = index;
+  event.channel = _rules[index].channel;
+  event.from = from;
+  event.to = _rules[index].state;
+
+  if(ENS160_EVENT_QUEUE <= _queued) {
+    _dropped++;   // Keep the newest events
+    _head = (_head + 1) % ENS160_EVENT_QUEUE;
+    _queued--;
+  }
+  _queue[(_head + _queued) % ENS160_EVENT_QUEUE] = event;
+  _queued++;
+  _wake = true;
+  if(NULL != _callback) {
+    _callback(&event);
+  }
+}
+
+bool DFRobot_ENS160_Events::checkWake(void)
+{
+  bool wake = _wake;
+  _wake = false;
+  return wake;
+}
+
+bool DFRobot_ENS160_Events::readEvent(sEvent_t *event)
+{
+  if(0 == _queued) {
+    return false;
+  }
+  *event = _queue[_head];
+  _head = (_head + 1) % ENS160_EVENT_QUEUE;
+  _queued--;
+  return true;
+}
+
+uint8_t DFRobot_ENS160_Events::getLevel(uint8_t rule)
+{
+  return (rule < _count) ? _rules[rule].state : 0;
+}
+
+uint32_t DFRobot_ENS160_Events::getDroppedCount(void)
+{
+  return _dropped;
+}
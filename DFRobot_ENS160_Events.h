@@ -0,0 +1,219 @@
+/*!
+ * @file  DFRobot_ENS160_Events.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Events class
+ * @details  Threshold events on the samples: level rules with hysteresis (AQI bands, eCO2 levels) and
+ * @n        rate-of-change rules (e.g. TVOC rising fast). Attached to a sensor, the rules are checked
+ * @n        on every sample read by readSnapshot(), also by the helper classes; a callback is called
+ * @n        and a wake flag is set only when an event fires.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_EVENTS_H__
+#define __DFRobot_ENS160_EVENTS_H__
+
+#include "DFRobot_ENS160.h"
+
+#define ENS160_EVENT_MAX_RULES    8   ///< Rules one engine can hold
+#define ENS160_EVENT_MAX_LEVELS   4   ///< Thresholds of one level rule
+#define ENS160_EVENT_QUEUE        8   ///< Events kept for readEvent()
+#define ENS160_EVENT_ECO2_HYST    50   ///< Default hysteresis of the eCO2 levels, unit: ppm
+#define ENS160_EVENT_AQI_CONFIRM  3   ///< Default number of samples confirming an AQI change
+#define ENS160_EVENT_RATE_WINDOW  10000   ///< Default time a rate of change is measured over, unit: ms
+
+class DFRobot_ENS160_Events
+{
+public:
+  /**
+   * @enum eChannel_t
+   * @brief Value a rule watches
+   */
+  typedef enum
+  {
+    eChannelAQI = 0,   /**< Air quality index, 1-5 */
+    eChannelTVOC,   /**< TVOC concentration, unit: ppb */
+    eChannelECO2,   /**< CO2 equivalent concentration, unit: ppm */
+  }eChannel_t;
+
+  /**
+   * @enum eRate_t
+   * @brief States of a rate-of-change rule, reported in sEvent_t from/to
+   */
+  typedef enum
+  {
+    eRateSteady = 0,   /**< Within the limit */
+    eRateRising,   /**< Rising faster than the limit */
+    eRateFalling,   /**< Falling faster than the limit */
+  }eRate_t;
+
+  /**
+   * @struct sEvent_t
+   * @brief One event
+   */
+  typedef struct
+  {
+    uint32_t   timestamp; /**< Time of the sample, unit: ms */
+    int32_t   value; /**< Level rule: the value; rate rule: the rate, unit: per minute */
+    uint8_t   rule; /**< Index returned when the rule was added */
+    uint8_t   channel; /**< eChannel_t */
+    uint8_t   from; /**< Previous level (number of thresholds reached) or eRate_t */
+    uint8_t   to; /**< New level or eRate_t */
+  } sEvent_t;
+
+  /**
+   * @brief Called when an event fires
+   * @param event The event
+   */
+  typedef void (*eventCallback_t)(const sEvent_t *event);
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Events
+   * @brief Constructor
+   * @return None
+   */
+  DFRobot_ENS160_Events(void);
+
+  /**
+   * @fn attach
+   * @brief Check the rules on every sample the sensor reads with readSnapshot()
+   * @param sensor The sensor, it takes the sample callback (see setSampleCallback())
+   * @return None
+   */
+  void attach(DFRobot_ENS160 *sensor);
+
+  /**
+   * @fn addLevels
+   * @brief Add a level rule, the level is the number of thresholds the value has reached
+   * @param channel eChannelAQI, eChannelTVOC or eChannelECO2
+   * @param levels Thresholds in ascending order
+   * @param num Number of thresholds, at most ENS160_EVENT_MAX_LEVELS
+   * @param hysteresis A level is only left downwards below threshold - hysteresis
+   * @param confirm Number of consecutive samples a new level must be seen before the event fires
+   * @return Index of the rule, -1 means no room or bad parameters
+   */
+  int addLevels(eChannel_t channel, const uint16_t *levels, uint8_t num, uint16_t hysteresis, uint8_t confirm=1);
+
+  /**
+   * @fn addAQIBand
+   * @brief Add a rule firing on every change of the AQI (1-5), level = AQI - 1
+   * @param confirm Number of consecutive samples a new AQI must be seen, the AQI has no room for a hysteresis
+   * @return Index of the rule, -1 means no room
+   */
+  int addAQIBand(uint8_t confirm=ENS160_EVENT_AQI_CONFIRM);
+
+  /**
+   * @fn addECO2Levels
+   * @brief Add a rule on the eCO2 levels of getECO2(): 600, 800, 1000 and 1500 ppm
+   * @param hysteresis unit: ppm
+   * @return Index of the rule, -1 means no room
+   */
+  int addECO2Levels(uint16_t hysteresis=ENS160_EVENT_ECO2_HYST);
+
+  /**
+   * @fn addRateLimit
+   * @brief Add a rate-of-change rule
+   * @details The rate is measured over back-to-back windows that do not overlap: the first sample after
+   * @n       a window has passed gives the rate since the start of the window and starts the next one.
+   * @n       The state changes at most once per window, a change is reported up to two windows late.
+   * @param channel eChannelAQI, eChannelTVOC or eChannelECO2
+   * @param limit Rate that fires the event, unit: per minute (e.g. ppb/min)
+   * @param hysteresis The rule returns to eRateSteady below limit - hysteresis
+   * @param window Time the rate is measured over, unit: ms
+   * @return Index of the rule, -1 means no room or bad parameters
+   */
+  int addRateLimit(eChannel_t channel, uint16_t limit, uint16_t hysteresis, uint32_t window=ENS160_EVENT_RATE_WINDOW);
+
+  /**
+   * @fn setEventCallback
+   * @brief Set the function called when an event fires
+   * @param callback The function, NULL removes it
+   * @return None
+   */
+  void setEventCallback(eventCallback_t callback);
+
+  /**
+   * @fn setValidOnly
+   * @brief Only check samples in normal operation (the default), or also warm-up and start-up samples
+   * @param validOnly true: normal operation only; false: all but invalid output
+   * @return None
+   */
+  void setValidOnly(bool validOnly);
+
+  /**
+   * @fn update
+   * @brief Check the rules on a sample, called by the sensor after attach()
+   * @param sample The sample
+   * @param timestamp Time of the sample, e.g. millis(), unit: ms
+   * @return true: at least one event fired
+   */
+  bool update(const DFRobot_ENS160::sSnapshot_t &sample, uint32_t timestamp);
+
+  /**
+   * @fn checkWake
+   * @brief Get and clear the wake flag, set whenever an event fires
+   * @return true: an event fired since the last call
+   */
+  bool checkWake(void);
+
+  /**
+   * @fn readEvent
+   * @brief Take the oldest event from the queue
+   * @param event Storage for the event
+   * @return true: success; false: no event
+   */
+  bool readEvent(sEvent_t *event);
+
+  /**
+   * @fn getLevel
+   * @brief Get the current level of a level rule or the eRate_t of a rate rule
+   * @param rule Index of the rule
+   * @return Level, 0 before the first sample
+   */
+  uint8_t getLevel(uint8_t rule);
+
+  /**
+   * @fn getDroppedCount
+   * @brief Get the number of events lost because the queue was full
+   * @return Number of events
+   */
+  uint32_t getDroppedCount(void);
+
+private:
+  typedef struct
+  {
+    bool   rate;   // Rate rule, else level rule
+    uint8_t   channel;
+    uint8_t   num;
+    uint16_t   levels[ENS160_EVENT_MAX_LEVELS];   // Level thresholds, or levels[0] = rate limit
+    uint16_t   hysteresis;
+    uint8_t   state;
+    uint8_t   confirm;   // Level rule: samples needed to accept a new level
+    uint8_t   candidate;   // Level seen in the last samples, not yet confirmed
+    uint8_t   pending;   // Number of samples candidate has been seen
+    bool   primed;   // The rule has seen a sample
+    uint16_t   refValue;   // Rate rule: value at the start of the current window
+    uint32_t   refTime;
+    uint32_t   window;
+  } sRule_t;
+
+  static void onSample(const DFRobot_ENS160::sSnapshot_t *snapshot, void *arg);
+  int addRule(const sRule_t &rule);
+  bool checkRule(uint8_t index, uint16_t value, uint32_t timestamp);
+  void fire(uint8_t index, uint8_t from, int32_t value, uint32_t timestamp);
+
+  sRule_t _rules[ENS160_EVENT_MAX_RULES];
+  uint8_t _count;
+  bool _validOnly;
+  eventCallback_t _callback;
+  volatile bool _wake;
+  sEvent_t _queue[ENS160_EVENT_QUEUE];
+  uint8_t _head;
+  uint8_t _queued;
+  uint32_t _dropped;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*!
+ * @file  DFRobot_ENS160_Fast.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Fast class template
+ * @details  Driver with the bus as template parameter instead of virtual readReg/writeReg: no vtable,
+ * @n        and the register accesses and decoding are inlined into the caller with constant sizes.
+ * @n        Bus is DFRobot_ENS160_I2CBus, DFRobot_ENS160_SPIBus or any class with the same
+ * @n        begin(), readReg() and writeReg() functions.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_FAST_H__
+#define __DFRobot_ENS160_FAST_H__
+
+#include "DFRobot_ENS160.h"
+
+template <class Bus>
+class DFRobot_ENS160_Fast
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_Fast
+   * @brief Constructor
+   * @param bus The bus, e.g. DFRobot_ENS160_I2CBus(&Wire, 0x53) or DFRobot_ENS160_SPIBus(&SPI, csPin)
+   * @return None
+   */
+  DFRobot_ENS160_Fast(const Bus &bus)
+    :_bus(bus)
+  {
+  }
+
+  /**
+   * @fn begin
+   * @brief Init function, same as DFRobot_ENS160::begin()
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS
+   * @retval -2 ERR_IC_VERSION
+   */
+  int begin(void)
+  {
+    uint8_t idBuf[2];
+    _bus.begin();
+    if(sizeof(idBuf) != _bus.readReg(ENS160_PART_ID_REG, idBuf, sizeof(idBuf))) {
+      DBG("ERR_DATA_BUS");
+      return ERR_DATA_BUS;
+    }
+    if(ENS160_PART_ID != ENS160_CONCAT_BYTES(idBuf[1], idBuf[0])) {
+      DBG("ERR_IC_VERSION");
+      return ERR_IC_VERSION;
+    }
+    setPWRMode(ENS160_STANDARD_MODE);
+    setINTMode(0x00);
+    return NO_ERR;
+  }
+
+  /**
+   * @fn setPWRMode
+   * @brief Set power mode, same as DFRobot_ENS160::setPWRMode()
+   * @param mode ENS160_SLEEP_MODE, ENS160_IDLE_MODE or ENS160_STANDARD_MODE
+   * @return None
+   */
+  void setPWRMode(uint8_t mode)
+  {
+    _bus.writeReg(ENS160_OPMODE_REG, &mode, sizeof(mode));
+    delay(ENS160_SWITCH_TIME);   // Give it some time to switch mode
+  }
+
+  /**
+   * @fn setINTMode
+   * @brief Interrupt config (INT), same as DFRobot_ENS160::setINTMode()
+   * @param mode Interrupt mode to be set
+   * @return None
+   */
+  void setINTMode(uint8_t mode)
+  {
+    if(0 == (mode & DFRobot_ENS160::eIntGprDrdyEN)) {
+      mode |= DFRobot_ENS160::eINTDataDrdyEN;
+    }
+    _bus.writeReg(ENS160_CONFIG_REG, &mode, sizeof(mode));
+    delay(ENS160_SWITCH_TIME);
+  }
+
+  /**
+   * @fn setTempAndHumFixed
+   * @brief Write compensation temperature and humidity, same as DFRobot_ENS160::setTempAndHumFixed()
+   * @param ambientTemp Ambient temperature, unit: 0.01 C, clamped to -40.00 - 85.00 C
+   * @param relativeHumidity Ambient humidity, unit: 0.01 %rH, clamped to 0.00 - 100.00 %rH
+   * @return None
+   */
+  void setTempAndHumFixed(int16_t ambientTemp, uint16_t relativeHumidity)
+  {
+    uint16_t temp, rh;
+    DFRobot_ENS160::encodeTempAndHum(ambientTemp, relativeHumidity, &temp, &rh);
+    uint8_t buf[4] = {(uint8_t)(temp & 0xFF), (uint8_t)(temp >> 8), (uint8_t)(rh & 0xFF), (uint8_t)(rh >> 8)};
+    _bus.writeReg(ENS160_TEMP_IN_REG, buf, sizeof(buf));
+  }
+
+  /**
+   * @fn getENS160Status
+   * @brief Get the sensor operating status, same as DFRobot_ENS160::getENS160Status()
+   * @return eNormalOperation, eWarmUpPhase, eInitialStartUpPhase or eInvalidOutput
+   */
+  uint8_t getENS160Status(void)
+  {
+    uint8_t data = 0;
+    _bus.readReg(ENS160_DATA_STATUS_REG, &data, sizeof(data));
+    return (data >> 2) & 0x03;   // VALIDITY FLAG
+  }
+
+  /**
+   * @fn getAQI
+   * @brief Get the air quality index, range: 1-5
+   * @return AQI
+   */
+  uint8_t getAQI(void)
+  {
+    uint8_t data = 0;
+    _bus.readReg(ENS160_DATA_AQI_REG, &data, sizeof(data));
+    return data;
+  }
+
+  /**
+   * @fn getTVOC
+   * @brief Get TVOC concentration, range: 0–65000, unit: ppb
+   * @return TVOC
+   */
+  uint16_t getTVOC(void)
+  {
+    uint8_t buf[2] = {0, 0};
+    _bus.readReg(ENS160_DATA_TVOC_REG, buf, sizeof(buf));
+    return ENS160_CONCAT_BYTES(buf[1], buf[0]);
+  }
+
+  /**
+   * @fn getECO2
+   * @brief Get CO2 equivalent concentration, range: 400–65000, unit: ppm
+   * @return eCO2
+   */
+  uint16_t getECO2(void)
+  {
+    uint8_t buf[2] = {0, 0};
+    _bus.readReg(ENS160_DATA_ECO2_REG, buf, sizeof(buf));
+    return ENS160_CONCAT_BYTES(buf[1], buf[0]);
+  }
+
+  /**
+   * @fn readSnapshot
+   * @brief Read status, AQI, TVOC and eCO2 in one bus transaction, same as DFRobot_ENS160::readSnapshot()
+   * @param snapshot Storage for the decoded sample
+   * @return int type, indicates the read result
+   * @retval 0 NO_ERR
+   * @retval -1 ERR_DATA_BUS
+   */
+  int readSnapshot(DFRobot_ENS160::sSnapshot_t *snapshot)
+  {
+    uint8_t buf[6] = {0};
+    if(NULL == snapshot) {
+      DBG("snapshot ERROR!! : null pointer");
+      return ERR_DATA_BUS;
+    }
+    if(sizeof(buf) != _bus.readReg(ENS160_DATA_STATUS_REG, buf, sizeof(buf))) {
+      return ERR_DATA_BUS;
+    }
+    memcpy(&snapshot->status, &buf[0], sizeof(snapshot->status));
+    snapshot->AQI = buf[1];
+    snapshot->TVOC = ENS160_CONCAT_BYTES(buf[3], buf[2]);
+    snapshot->ECO2 = ENS160_CONCAT_BYTES(buf[5], buf[4]);
+    snapshot->stale = 0;
+    return NO_ERR;
+  }
+
+private:
+  Bus _bus;
+};
+
+#endif
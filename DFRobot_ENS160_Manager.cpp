@@ -0,0 +1,160 @@
+/*!
+ * @file DFRobot_ENS160_Manager.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Manager class
+ * @n Poll several ENS160 sensors sharing I2C/SPI buses.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Manager.h"
+
+DFRobot_ENS160_Manager::DFRobot_ENS160_Manager(void)
+{
+  _count = 0;
+  _next = 0;
+  _start = 0;
+  _sweeps = 0;
+}
+
+int DFRobot_ENS160_Manager::addSensor(DFRobot_ENS160 *sensor)
+{
+  if((NULL == sensor) || (ENS160_MANAGER_MAX_SENSORS <= _count)) {
+    DBG("sensor ERROR!! : null pointer or manager full");
+    return -1;
+  }
+  _sensors[_count] = sensor;
+  memset(&_health[_count], 0, sizeof(sSensorHealth_t));
+  _reinit[_count] = false;
+  _health[_count].lastResult = NO_ERR;
+  _health[_count].online = true;
+  return _count++;
+}
+
+uint8_t DFRobot_ENS160_Manager::getSensorCount(void)
+{
+  return _count;
+}
+
+uint8_t DFRobot_ENS160_Manager::begin(void)
+{
+  uint8_t ok = 0;
+  for(uint8_t i = 0; i < _count; i++) {
+    _health[i].lastResult = _sensors[i]->beginAsync();
+    _health[i].online = (NO_ERR == _health[i].lastResult);
+    _reinit[i] = false;
+  }
+
+  // All sensors switch mode and config at the same time
+  bool ready = false;
+  while(!ready) {
+    ready = true;
+    for(uint8_t i = 0; i < _count; i++) {
+      if(_health[i].online && !_sensors[i]->poll()) {
+        ready = false;
+      }
+    }
+    if(!ready) {
+      yield();
+    }
+  }
+
+  for(uint8_t i = 0; i < _count; i++) {
+    if(_health[i].online) {
+      ok++;
+    }
+  }
+  _next = 0;
+  _start = 0;
+  return ok;
+}
+
+uint8_t DFRobot_ENS160_Manager::sweep(DFRobot_ENS160::sSnapshot_t *samples)
+{
+  uint8_t ok = 0;
+  if((NULL == samples) || (0 == _count)) {
+    return 0;
+  }
+  _next = 0;   // Drop a cycle left unfinished by step()
+  for(uint8_t n = 0; n < _count; n++) {
+    uint8_t index = (_start + n) % _count;
+    if(readSensor(index, samples)) {
+      ok++;
+    }
+  }
+  _start = (_start + 1) % _count;
+  _sweeps++;
+  return ok;
+}
+
+bool DFRobot_ENS160_Manager::step(DFRobot_ENS160::sSnapshot_t *samples)
+{
+  if((NULL == samples) || (0 == _count)) {
+    return false;
+  }
+  readSensor((_start + _next) % _count, samples);
+  if(++_next < _count) {
+    return false;
+  }
+  _next = 0;
+  _start = (_start + 1) % _count;
+  _sweeps++;
+  return true;
+}
+
+bool DFRobot_ENS160_Manager::getHealth(uint8_t index, sSensorHealth_t *health)
+{
+  if((index >= _count) || (NULL == health)) {
+    return false;
+  }
+  *health = _health[index];
+  return true;
+}
+
+bool DFRobot_ENS160_Manager::shouldRead(uint8_t index)
+{
+  // Offline sensors cost bus time (NACK or timeout), so only retry them now and then
+  return _health[index].online || _reinit[index] || (0 == (_sweeps % ENS160_MANAGER_RETRY_SWEEPS));
+}
+
+bool DFRobot_ENS160_Manager::readSensor(uint8_t index, DFRobot_ENS160::sSnapshot_t *samples)
+{
+  sSensorHealth_t *health = &_health[index];
+  if(!shouldRead(index)) {
+    return false;
+  }
+
+  if(!health->online && !_reinit[index]) {
+    // The sensor may have been power cycled or never initialized, its reads alone prove nothing
+    health->reads++;
+    health->lastResult = _sensors[index]->beginAsync();
+    if(NO_ERR == health->lastResult) {
+      _reinit[index] = true;   // Read it once the mode and config switch is done
+      return false;
+    }
+  } else {
+    if(_reinit[index]) {
+      if(!_sensors[index]->poll()) {
+        return false;
+      }
+      _reinit[index] = false;
+    }
+    health->reads++;
+    health->lastResult = _sensors[index]->readSnapshot(&samples[index]);
+  }
+  if(NO_ERR != health->lastResult) {
+    health->errors++;
+    if(health->consecutiveErrors < 0xFF) {
+      health->consecutiveErrors++;
+    }
+    if(health->consecutiveErrors >= ENS160_MANAGER_OFFLINE_COUNT) {
+      health->online = false;
+    }
+    return false;
+  }
+  health->consecutiveErrors = 0;
+  health->online = true;
+  return true;
+}
@@ -0,0 +1,112 @@
+/*!
+ * @file  DFRobot_ENS160_Manager.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Manager class
+ * @details  Poll several ENS160 sensors sharing I2C/SPI buses, one bus transaction per sensor per cycle,
+ * @n        and keep health information of every sensor.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_MANAGER_H__
+#define __DFRobot_ENS160_MANAGER_H__
+
+#include "DFRobot_ENS160.h"
+
+#ifndef ENS160_MANAGER_MAX_SENSORS
+  #define ENS160_MANAGER_MAX_SENSORS   8   ///< Maximum number of sensors one manager can own
+#endif
+#define ENS160_MANAGER_OFFLINE_COUNT   3   ///< Consecutive failed reads after which a sensor is regarded as offline
+#define ENS160_MANAGER_RETRY_SWEEPS    16  ///< An offline sensor is retried once every this many cycles
+
+class DFRobot_ENS160_Manager
+{
+public:
+  /**
+   * @struct sSensorHealth_t
+   * @brief Health information of one sensor
+   */
+  typedef struct
+  {
+    uint32_t   reads; /**< Number of reads attempted */
+    uint32_t   errors; /**< Number of reads that failed */
+    uint8_t   consecutiveErrors; /**< Number of failed reads since the last good one */
+    int   lastResult; /**< Result of the last read: NO_ERR, ERR_DATA_BUS, ERR_IC_VERSION or ERR_MISR_CHECK */
+    bool   online; /**< false after ENS160_MANAGER_OFFLINE_COUNT consecutive failed reads or a failed begin(),
+                        an offline sensor is initialized again before it is read, see sweep() */
+  } sSensorHealth_t;
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Manager
+   * @brief Constructor
+   * @return None
+   */
+  DFRobot_ENS160_Manager(void);
+
+  /**
+   * @fn addSensor
+   * @brief Add a sensor to the manager, the manager does not take over the object memory
+   * @param sensor A DFRobot_ENS160_I2C or DFRobot_ENS160_SPI object
+   * @return Index of the sensor in the sample array, -1 means the manager is full
+   */
+  int addSensor(DFRobot_ENS160 *sensor);
+
+  /**
+   * @fn getSensorCount
+   * @brief Get the number of sensors owned by the manager
+   * @return Number of sensors
+   */
+  uint8_t getSensorCount(void);
+
+  /**
+   * @fn begin
+   * @brief Init all sensors, the mode and config switch times of all sensors overlap
+   * @return Number of sensors initialized successfully
+   */
+  uint8_t begin(void);
+
+  /**
+   * @fn sweep
+   * @brief Read every online sensor once, in round-robin order
+   * @param samples Array with getSensorCount() elements, sample of sensor i is stored in samples[i]
+   * @return Number of sensors read successfully in this cycle
+   * @note Check getHealth() to know which elements were updated
+   * @note An offline sensor is initialized again without blocking: beginAsync() in one cycle, the mode and
+   * @n    config switch in the following ones, then it is read. This restarts its warm-up, like any begin().
+   */
+  uint8_t sweep(DFRobot_ENS160::sSnapshot_t *samples);
+
+  /**
+   * @fn step
+   * @brief Read the next sensor of the current cycle, so a cycle can be spread over several loop() calls
+   * @param samples Array with getSensorCount() elements, sample of sensor i is stored in samples[i]
+   * @return true: a cycle is complete and samples holds the batch; false: the cycle is in progress
+   */
+  bool step(DFRobot_ENS160::sSnapshot_t *samples);
+
+  /**
+   * @fn getHealth
+   * @brief Get the health information of a sensor
+   * @param index Index returned by addSensor()
+   * @param health Storage for the health information
+   * @return true: success; false: index out of range
+   */
+  bool getHealth(uint8_t index, sSensorHealth_t *health);
+
+private:
+  bool readSensor(uint8_t index, DFRobot_ENS160::sSnapshot_t *samples);
+  bool shouldRead(uint8_t index);
+
+  DFRobot_ENS160 *_sensors[ENS160_MANAGER_MAX_SENSORS];
+  sSensorHealth_t _health[ENS160_MANAGER_MAX_SENSORS];
+  uint8_t _count;   // Number of sensors
+  uint8_t _next;   // Position of the next sensor in the current cycle
+  uint8_t _start;   // Sensor the current cycle started with, rotated every cycle
+  uint8_t _sweeps;   // Cycle counter used to retry offline sensors
+  bool _reinit[ENS160_MANAGER_MAX_SENSORS];   // Offline sensor is switching mode and config after beginAsync()
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*!
+ * @file DFRobot_ENS160_Poller.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Poller class
+ * @n Phase-locked polling of the conversions.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Poller.h"
+
+DFRobot_ENS160_Poller::DFRobot_ENS160_Poller(DFRobot_ENS160 *sensor)
+{
+  _sensor = sensor;
+  begin();
+}
+
+void DFRobot_ENS160_Poller::begin(void)
+{
+  _locked = false;
+  _missed = false;
+  _havePrev = false;
+  _period = ENS160_POLL_PERIOD;
+  _step = ENS160_POLL_STEP;
+  _hits = 0;
+  _next = micros();
+  _expected = _next;
+  _lastMiss = _next;
+  _prevEdge = 0;
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+bool DFRobot_ENS160_Poller::poll(DFRobot_ENS160::sTimedSnapshot_t *sample)
+{
+  uint32_t now = micros();
+  if((int32_t)(now - _next) < 0) {
+    return false;
+  }
+
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  _stats.transactions++;
+  if(NO_ERR != _sensor->readSnapshot(&snapshot)) {
+    _stats.errors++;
+    _next = now + ENS160_POLL_RETRY;
+    return false;
+  }
+
+  if(!snapshot.status.dataDrdy) {
+    if(_locked && ((int32_t)(now - _expected) > (int32_t)(_period / 4))) {
+      DBG("phase lost");   // E.g. the sensor was switched out of STANDARD mode
+      _locked = false;
+      _havePrev = false;
+      _stats.relocks++;
+    }
+    _missed = true;
+    _lastMiss = now;
+    _next = now + (_locked ? ENS160_POLL_RETRY : ENS160_POLL_SEARCH);
+    return false;
+  }
+
+  if(!_locked) {
+    // Data ready lies between the last read and this one, aim the next read before it
+    uint32_t edge = _missed ? (now - (now - _lastMiss) / 2) : now;
+    _expected = edge + _period;
+    _next = _expected - ENS160_POLL_SEARCH;
+    _locked = true;
+  } else if(_missed) {
+    // Data ready lies between the last two reads, ENS160_POLL_RETRY apart: re-lock
+    uint32_t edge = now - (now - _lastMiss) / 2;
+    learnPeriod(edge);
+    _stats.latency = now - _lastMiss;
+    _expected = edge + _period;
+    _next = _expected + ENS160_POLL_GUARD;
+  } else {
+    // Data was already there, read a little earlier next time until a read comes too early.
+    // Locked on the right period that takes two reads; after more the chip runs faster than the
+    // learned period, so the step doubles to catch up with it
+    _expected += _period - _step;
+    _next = _expected + ENS160_POLL_GUARD;
+    if((++_hits >= ENS160_POLL_HITS) && (_step < _period / 16)) {
+      _step *= 2;
+    }
+  }
+  if(_missed) {
+    _hits = 0;
+    _step = ENS160_POLL_STEP;
+  }
+  _missed = false;
+
+  sample->timestamp = millis();
+  sample->data = snapshot;
+  _stats.samples++;
+  return true;
+}
+
+uint32_t DFRobot_ENS160_Poller::getWaitTime(void)
+{
+  int32_t wait = (int32_t)(_next - micros());
+  return (wait > 0) ? (uint32_t)wait : 0;
+}
+
+bool DFRobot_ENS160_Poller::isLocked(void)
+{
+  return _locked;
+}
+
+void DFRobot_ENS160_Poller::getPollStats(sPollStats_t *stats)
+{
+  if(NULL == stats) {
+    DBG("stats ERROR!! : null pointer");
+    return;
+  }
+  *stats = _stats;
+  stats->period = _period;
+}
+
+void DFRobot_ENS160_Poller::learnPeriod(uint32_t edge)
+{
+  if(_havePrev) {
+    uint32_t elapsed = edge - _prevEdge;
+    uint32_t cycles = (elapsed + _period / 2) / _period;
+    if((cycles > 0) && (cycles <= 16)) {
+      int32_t error = (int32_t)(elapsed / cycles) - (int32_t)_period;
+      if(abs(error) < (int32_t)(_period / 16)) {   // Ignore outliers, e.g. a delayed loop()
+        // The longer the measurement, the smaller its error: weight cycles / (cycles + 2^n)
+        _period += error * (int32_t)cycles / (int32_t)(cycles + (1 << ENS160_POLL_PERIOD_SHIFT));
+      }
+    }
+  }
+  _prevEdge = edge;
+  _havePrev = true;
+}
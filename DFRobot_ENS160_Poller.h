@@ -0,0 +1,109 @@
+/*!
+ * @file  DFRobot_ENS160_Poller.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Poller class
+ * @details  Phase-locked polling for boards without the INTn pin wired. The conversion period and phase
+ * @n        are learned from the NEWDAT bit that comes with every snapshot read, and the next read is
+ * @n        scheduled just after the expected data ready time. A read that finds new data moves the
+ * @n        next read a little earlier; a read that finds none is retried at a short interval, and
+ * @n        the transition re-locks the phase and refines the period, so clock drift is followed.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_POLLER_H__
+#define __DFRobot_ENS160_POLLER_H__
+
+#include "DFRobot_ENS160.h"
+
+#define ENS160_POLL_PERIOD       1000000   ///< Nominal conversion period in STANDARD mode, unit: us
+#define ENS160_POLL_GUARD        1000   ///< Delay of a read after the expected data ready time, unit: us
+#define ENS160_POLL_STEP         1000   ///< A read that finds new data moves the next one this much earlier, unit: us
+#define ENS160_POLL_HITS         2   ///< Reads in a row that find new data before the step doubles
+#define ENS160_POLL_RETRY        1000   ///< Read interval after a read without new data while locked, unit: us
+#define ENS160_POLL_SEARCH       10000   ///< Read interval while searching for the phase, unit: us
+#define ENS160_POLL_PERIOD_SHIFT 3   ///< Weight of a new period measurement over c cycles: c/(c + 2^n)
+
+class DFRobot_ENS160_Poller
+{
+public:
+  /**
+   * @struct sPollStats_t
+   * @brief Polling statistics
+   */
+  typedef struct
+  {
+    uint32_t   samples; /**< Number of samples delivered */
+    uint32_t   transactions; /**< Number of snapshot reads, one bus transaction each */
+    uint32_t   errors; /**< Number of failed reads */
+    uint32_t   relocks; /**< Number of times the phase was lost and searched again */
+    uint32_t   period; /**< Learned conversion period, unit: us */
+    uint32_t   latency; /**< Upper bound of the data ready to read delay of the last re-locked sample, unit: us */
+  } sPollStats_t;
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Poller
+   * @brief Constructor
+   * @param sensor A DFRobot_ENS160_I2C or DFRobot_ENS160_SPI object in STANDARD mode
+   * @return None
+   */
+  DFRobot_ENS160_Poller(DFRobot_ENS160 *sensor);
+
+  /**
+   * @fn begin
+   * @brief Start searching for the phase, also resets the statistics
+   * @return None
+   */
+  void begin(void);
+
+  /**
+   * @fn poll
+   * @brief Read the sensor if a read is due, call it from loop(); it never blocks
+   * @param sample Storage for the sample, timestamp is millis() of the read
+   * @return true: a new sample is stored in sample; false: no new sample
+   */
+  bool poll(DFRobot_ENS160::sTimedSnapshot_t *sample);
+
+  /**
+   * @fn getWaitTime
+   * @brief Get the time until the next read is due, the host may sleep that long
+   * @return unit: us
+   */
+  uint32_t getWaitTime(void);
+
+  /**
+   * @fn isLocked
+   * @brief Whether the phase of the conversions is known
+   * @return true: locked; false: searching
+   */
+  bool isLocked(void);
+
+  /**
+   * @fn getPollStats
+   * @brief Get the polling statistics
+   * @param stats Storage for the statistics
+   * @return None
+   */
+  void getPollStats(sPollStats_t *stats);
+
+private:
+  void learnPeriod(uint32_t edge);
+
+  DFRobot_ENS160 *_sensor;
+  bool _locked;
+  bool _missed;   // The last read found no new data
+  bool _havePrev;   // _prevEdge holds a re-locked data ready time
+  uint32_t _period;
+  uint32_t _step;   // How much earlier the next read is moved
+  uint8_t _hits;   // Reads in a row that found new data
+  uint32_t _expected;   // Expected time of the next data ready
+  uint32_t _next;   // Time of the next read
+  uint32_t _lastMiss;   // Time of the last read without new data
+  uint32_t _prevEdge;
+  sPollStats_t _stats;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*!
+ * @file  DFRobot_ENS160_SampleQueue.h
+ * @brief  Define infrastructure of DFRobot_ENS160_SampleQueue class
+ * @details  Lock-free single-producer/single-consumer queue of timestamped samples, fed by the
+ * @n        DATA_DRDY interrupt of the INTn pin. The interrupt only records the time, the bus read is
+ * @n        deferred to service(), and the application drains the samples in batches.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_SAMPLE_QUEUE_H__
+#define __DFRobot_ENS160_SAMPLE_QUEUE_H__
+
+#include "DFRobot_ENS160.h"
+
+/**
+ * @brief Sample queue
+ * @param CAPACITY Number of samples the queue can hold, must be a power of two not greater than 128
+ * @note service() (producer) and drain() (consumer) may run in different tasks or contexts, even on
+ * @n    different cores, but each of them must only be called from one context. The indices are
+ * @n    published with release stores and read with acquire loads, so a sample is complete before
+ * @n    the consumer sees it and a slot is copied out before the producer reuses it.
+ */
+template <uint8_t CAPACITY>
+class DFRobot_ENS160_SampleQueue
+{
+  static_assert((CAPACITY > 0) && (CAPACITY <= 128) && (0 == (CAPACITY & (CAPACITY - 1))),
+                "CAPACITY must be a power of two not greater than 128");
+
+public:
+  /**
+   * @fn DFRobot_ENS160_SampleQueue
+   * @brief Constructor
+   * @param sensor The sensor, its interrupt must be enabled by setINTMode(eINTModeEN | ...)
+   * @return None
+   */
+  DFRobot_ENS160_SampleQueue(DFRobot_ENS160 *sensor)
+  {
+    _sensor = sensor;
+    _head = 0;
+    _tail = 0;
+    _pending = false;
+    _readyTime = 0;
+    _overrun = 0;
+    _missed = 0;
+    _readErr = 0;
+  }
+
+  /**
+   * @fn onDataReady
+   * @brief Call it from the INTn interrupt service routine, it does not touch the bus
+   * @return None
+   */
+  void onDataReady(void)
+  {
+    if(_pending) {
+      _missed++;   // The previous data ready was not serviced in time
+    }
+    _readyTime = millis();
+    _pending = true;
+  }
+
+  /**
+   * @fn service
+   * @brief Deferred read, reads the sensor if a data ready interrupt is pending and pushes the sample
+   * @return true: a sample was pushed into the queue; false: nothing pending, read failed or queue full
+   */
+  bool service(void)
+  {
+    if(!_pending) {
+      return false;
+    }
+    noInterrupts();
+    uint32_t readyTime = _readyTime;
+    _pending = false;
+    interrupts();
+
+    DFRobot_ENS160::sTimedSnapshot_t sample;
+    sample.timestamp = readyTime;
+    if(NO_ERR != _sensor->readSnapshot(&sample.data)) {
+      _readErr++;
+      return false;
+    }
+    return push(sample);
+  }
+
+  /**
+   * @fn push
+   * @brief Push a sample read elsewhere into the queue (producer side)
+   * @param sample The sample
+   * @return true: success; false: the queue is full, the sample is dropped and counted as overrun
+   */
+  bool push(const DFRobot_ENS160::sTimedSnapshot_t &sample)
+  {
+    uint8_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+    uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    if(CAPACITY == (uint8_t)(head - tail)) {
+      _overrun++;
+      return false;
+    }
+    _buf[head & (CAPACITY - 1)] = sample;
+    __atomic_store_n(&_head, (uint8_t)(head + 1), __ATOMIC_RELEASE);   // Publish the sample after it is written
+    return true;
+  }
+
+  /**
+   * @fn drain
+   * @brief Take up to maxNum samples out of the queue, oldest first (consumer side)
+   * @param samples Storage for the samples
+   * @param maxNum Capacity of samples
+   * @return Number of samples taken out
+   */
+  uint8_t drain(DFRobot_ENS160::sTimedSnapshot_t *samples, uint8_t maxNum)
+  {
+    uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+    uint8_t num = (uint8_t)(__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - tail);
+    if(num > maxNum) {
+      num = maxNum;
+    }
+    for(uint8_t i = 0; i < num; i++) {
+      samples[i] = _buf[(uint8_t)(tail + i) & (CAPACITY - 1)];
+    }
+    __atomic_store_n(&_tail, (uint8_t)(tail + num), __ATOMIC_RELEASE);   // Free the slots after they are copied
+    return num;
+  }
+
+  /**
+   * @fn available
+   * @brief Get the number of samples in the queue
+   * @return Number of samples
+   */
+  uint8_t available(void)
+  {
+    return (uint8_t)(__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE));
+  }
+
+  /**
+   * @fn getOverrunCount
+   * @brief Get the number of samples dropped because the queue was full
+   * @return Overrun count
+   */
+  uint32_t getOverrunCount(void)
+  {
+    return _overrun;
+  }
+
+  /**
+   * @fn getMissedCount
+   * @brief Get the number of data ready interrupts that came before the previous one was serviced
+   * @return Missed count
+   */
+  uint32_t getMissedCount(void)
+  {
+    return _missed;
+  }
+
+  /**
+   * @fn getReadErrCount
+   * @brief Get the number of deferred reads that failed
+   * @return Read error count
+   */
+  uint32_t getReadErrCount(void)
+  {
+    return _readErr;
+  }
+
+private:
+  DFRobot_ENS160 *_sensor;
+  DFRobot_ENS160::sTimedSnapshot_t _buf[CAPACITY];
+  uint8_t _head;   // Free-running write index, only changed by the producer, atomic access only
+  uint8_t _tail;   // Free-running read index, only changed by the consumer, atomic access only
+  volatile bool _pending;   // Set by the interrupt, cleared by service()
+  volatile uint32_t _readyTime;   // millis() of the last data ready interrupt
+  volatile uint32_t _missed;
+  uint32_t _overrun;
+  uint32_t _readErr;
+};
+
+#endif
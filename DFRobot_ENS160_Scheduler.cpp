@@ -0,0 +1,184 @@
+/*!
+ * @file DFRobot_ENS160_Scheduler.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Scheduler class
+ * @n Duty-cycle the sensor for a target sample interval.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Scheduler.h"
+
+DFRobot_ENS160_Scheduler::DFRobot_ENS160_Scheduler(DFRobot_ENS160 *sensor)
+{
+  _sensor = sensor;
+  _policy = eAccuracyValid;
+  _state = eStateRunning;
+  _interval = 0;
+  _lead = ENS160_SCHED_WARM_UP;
+  setModePower(ENS160_SCHED_SLEEP_POWER, ENS160_SCHED_IDLE_POWER, ENS160_SCHED_STANDARD_POWER);
+  resetEnergyStats();
+}
+
+void DFRobot_ENS160_Scheduler::begin(uint32_t interval, eAccuracyPolicy_t policy)
+{
+  uint32_t now = millis();
+  _interval = interval;
+  _policy = policy;
+  _lead = (eAccuracyValid == _policy) ? ENS160_SCHED_WARM_UP : ENS160_SCHED_MIN_ON;
+
+  // The sensor may already be warm, so check right away; this first warm-up is not measured
+  _sensor->setPWRModeAsync(ENS160_STANDARD_MODE);
+  _state = eStateWarmUp;
+  _onStart = now;
+  _nextSample = now;
+  _nextCheck = now;
+  _learn = false;
+  _startUp = false;
+  _lastStep = now;
+}
+
+void DFRobot_ENS160_Scheduler::setModePower(uint32_t sleepPower, uint32_t idlePower, uint32_t standardPower)
+{
+  _power[ENS160_SLEEP_MODE] = sleepPower;
+  _power[ENS160_IDLE_MODE] = idlePower;
+  _power[ENS160_STANDARD_MODE] = standardPower;
+}
+
+bool DFRobot_ENS160_Scheduler::step(DFRobot_ENS160::sSnapshot_t *sample)
+{
+  uint32_t now = millis();
+  account(now);
+  if(!_sensor->poll()) {   // Mode switch in progress
+    return false;
+  }
+
+  if(eStateSleep == _state) {
+    if((int32_t)(now - (_nextSample - _lead)) < 0) {
+      return false;
+    }
+    _sensor->setPWRModeAsync(ENS160_STANDARD_MODE);
+    _state = eStateWarmUp;
+    _onStart = now;
+    _learn = (eAccuracyValid == _policy);
+    _startUp = false;
+    // Start checking a little early, so a heating time that was too long shrinks over the cycles
+    _nextCheck = now + ((_lead > 2 * ENS160_SCHED_MARGIN) ? (_lead - 2 * ENS160_SCHED_MARGIN) : 0);
+    if(eAccuracyRelaxed == _policy) {
+      _nextCheck = now + _lead;
+    }
+    _wakeUps++;
+    return false;
+  }
+
+  if((int32_t)(now - _nextCheck) < 0) {
+    return false;
+  }
+  _nextCheck = now + ENS160_SCHED_CHECK;
+
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  if(NO_ERR != _sensor->readSnapshot(&snapshot)) {
+    return false;
+  }
+  if(!accept(snapshot, now)) {
+    _state = eStateWarmUp;   // Also when a running sensor falls back into a warm-up phase
+    return false;
+  }
+
+  if(eStateWarmUp == _state) {
+    if(_learn && !_startUp) {
+      _lead = (now - _onStart) + ENS160_SCHED_MARGIN;
+    }
+    _learn = false;
+    _state = eStateRunning;
+  }
+  if((int32_t)(now - _nextSample) < 0) {   // Warm earlier than needed, read at the sample time
+    _nextCheck = _nextSample;
+    return false;
+  }
+
+  *sample = snapshot;
+  deliver(now);
+  return true;
+}
+
+uint32_t DFRobot_ENS160_Scheduler::getSleepTime(void)
+{
+  uint32_t now = millis();
+  if(!_sensor->isReady()) {
+    return 0;
+  }
+  uint32_t next = (eStateSleep == _state) ? (_nextSample - _lead) : _nextCheck;
+  return ((int32_t)(next - now) > 0) ? (next - now) : 0;
+}
+
+bool DFRobot_ENS160_Scheduler::isDutyCycling(void)
+{
+  return _interval > (_lead + ENS160_SCHED_MIN_SLEEP);
+}
+
+void DFRobot_ENS160_Scheduler::getEnergyStats(sEnergyStats_t *stats)
+{
+  if(NULL == stats) {
+    DBG("stats ERROR!! : null pointer");
+    return;
+  }
+  account(millis());
+  stats->sleepTime = _time[ENS160_SLEEP_MODE];
+  stats->idleTime = _time[ENS160_IDLE_MODE];
+  stats->standardTime = _time[ENS160_STANDARD_MODE];
+  // ms * uW = nJ
+  stats->energy = ((float)_time[ENS160_SLEEP_MODE] * _power[ENS160_SLEEP_MODE] +
+                   (float)_time[ENS160_IDLE_MODE] * _power[ENS160_IDLE_MODE] +
+                   (float)_time[ENS160_STANDARD_MODE] * _power[ENS160_STANDARD_MODE]) / 1000000.0;
+  stats->samples = _samples;
+  stats->wakeUps = _wakeUps;
+  stats->warmUpTime = _lead;
+}
+
+void DFRobot_ENS160_Scheduler::resetEnergyStats(void)
+{
+  memset(_time, 0, sizeof(_time));
+  _samples = 0;
+  _wakeUps = 0;
+  _lastStep = millis();
+}
+
+void DFRobot_ENS160_Scheduler::account(uint32_t now)
+{
+  uint8_t mode = _sensor->getCachedPWRMode();
+  if((_sensor->getCacheFlags() & ENS160_CACHE_OPMODE) && (mode <= ENS160_STANDARD_MODE)) {   // Unknown mode: not counted
+    _time[mode] += now - _lastStep;
+  }
+  _lastStep = now;
+}
+
+bool DFRobot_ENS160_Scheduler::accept(const DFRobot_ENS160::sSnapshot_t &sample, uint32_t now)
+{
+  uint8_t validity = sample.status.validityFlag;
+  if(eAccuracyRelaxed == _policy) {
+    return (DFRobot_ENS160::eInvalidOutput != validity) && ((uint32_t)(now - _onStart) >= ENS160_SCHED_MIN_ON);
+  }
+  if(DFRobot_ENS160::eInitialStartUpPhase == validity) {
+    _startUp = true;   // Runs once in the sensor's lifetime, this warm-up says nothing about the next ones
+  }
+  return DFRobot_ENS160::eNormalOperation == validity;
+}
+
+void DFRobot_ENS160_Scheduler::deliver(uint32_t now)
+{
+  _samples++;
+  _nextSample += _interval;
+  if((int32_t)(now - _nextSample) >= 0) {   // Fell behind, e.g. a long warm-up
+    _nextSample = now + _interval;
+  }
+
+  if(isDutyCycling()) {
+    _sensor->setPWRModeAsync(ENS160_SLEEP_MODE);
+    _state = eStateSleep;
+  } else {
+    _nextCheck = _nextSample;
+  }
+}
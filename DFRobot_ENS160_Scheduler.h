@@ -0,0 +1,153 @@
+/*!
+ * @file  DFRobot_ENS160_Scheduler.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Scheduler class
+ * @details  Duty-cycle the sensor between DEEP SLEEP and STANDARD mode for a target sample interval.
+ * @n        The heater is only switched on so long before the next sample that the output is valid
+ * @n        when it is read; the heating time is learned from the validity flag. Time spent in each
+ * @n        mode is tracked and turned into an energy estimate.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_SCHEDULER_H__
+#define __DFRobot_ENS160_SCHEDULER_H__
+
+#include "DFRobot_ENS160.h"
+
+#define ENS160_SCHED_WARM_UP     180000   ///< Heating time assumed until one has been measured, unit: ms
+#define ENS160_SCHED_MIN_ON      3000   ///< Heating time before a sample is accepted by eAccuracyRelaxed, unit: ms
+#define ENS160_SCHED_MARGIN      2000   ///< Added to the measured heating time, unit: ms
+#define ENS160_SCHED_MIN_SLEEP   5000   ///< Shorter sleep phases are not worth a new warm-up, unit: ms
+#define ENS160_SCHED_CHECK       1000   ///< Status check period while heating, one conversion, unit: ms
+
+/* Typical supply power of the modes from the datasheet, unit: uW */
+#define ENS160_SCHED_SLEEP_POWER      10
+#define ENS160_SCHED_IDLE_POWER       500
+#define ENS160_SCHED_STANDARD_POWER   32000
+
+class DFRobot_ENS160_Scheduler
+{
+public:
+  /**
+   * @enum eAccuracyPolicy_t
+   * @brief Which samples the scheduler delivers
+   */
+  typedef enum
+  {
+    eAccuracyValid = 0,   /**< Only samples in normal operation; the heater runs until the warm-up phase is over */
+    eAccuracyRelaxed,   /**< Any sample except invalid output, after ENS160_SCHED_MIN_ON of heating */
+  }eAccuracyPolicy_t;
+
+  /**
+   * @struct sEnergyStats_t
+   * @brief Time spent in each mode and the resulting energy estimate
+   */
+  typedef struct
+  {
+    uint32_t   sleepTime; /**< Time in DEEP SLEEP mode, unit: ms */
+    uint32_t   idleTime; /**< Time in IDLE mode, unit: ms */
+    uint32_t   standardTime; /**< Time in STANDARD mode, unit: ms */
+    float   energy; /**< Estimated sensor energy, unit: mJ */
+    uint32_t   samples; /**< Number of samples delivered */
+    uint32_t   wakeUps; /**< Number of switches from DEEP SLEEP to STANDARD mode */
+    uint32_t   warmUpTime; /**< Heating time currently used before a sample, unit: ms */
+  } sEnergyStats_t;
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Scheduler
+   * @brief Constructor
+   * @param sensor A DFRobot_ENS160_I2C or DFRobot_ENS160_SPI object, begin() must have been called
+   * @return None
+   */
+  DFRobot_ENS160_Scheduler(DFRobot_ENS160 *sensor);
+
+  /**
+   * @fn begin
+   * @brief Start scheduling, the first sample is delivered as soon as the output is acceptable
+   * @param interval Target sample interval, unit: ms
+   * @param policy eAccuracyValid or eAccuracyRelaxed
+   * @return None
+   */
+  void begin(uint32_t interval, eAccuracyPolicy_t policy = eAccuracyValid);
+
+  /**
+   * @fn setModePower
+   * @brief Set the supply power of the modes used for the energy estimate
+   * @param sleepPower DEEP SLEEP mode, unit: uW
+   * @param idlePower IDLE mode, unit: uW
+   * @param standardPower STANDARD mode, unit: uW
+   * @return None
+   */
+  void setModePower(uint32_t sleepPower, uint32_t idlePower, uint32_t standardPower);
+
+  /**
+   * @fn step
+   * @brief Run the scheduler, call it from loop(); it never blocks
+   * @param sample Storage for the sample
+   * @return true: a new sample is stored in sample; false: nothing to deliver now
+   */
+  bool step(DFRobot_ENS160::sSnapshot_t *sample);
+
+  /**
+   * @fn getSleepTime
+   * @brief Get the time until step() has work to do, the host may sleep that long
+   * @return unit: ms
+   */
+  uint32_t getSleepTime(void);
+
+  /**
+   * @fn isDutyCycling
+   * @brief Whether the sensor sleeps between samples
+   * @return false: the interval is too short compared to the warm-up, the heater stays on
+   */
+  bool isDutyCycling(void);
+
+  /**
+   * @fn getEnergyStats
+   * @brief Get the time spent in each mode and the energy estimate
+   * @param stats Storage for the statistics
+   * @return None
+   */
+  void getEnergyStats(sEnergyStats_t *stats);
+
+  /**
+   * @fn resetEnergyStats
+   * @brief Reset the statistics
+   * @return None
+   */
+  void resetEnergyStats(void);
+
+private:
+  typedef enum
+  {
+    eStateSleep = 0,   // Waiting in DEEP SLEEP mode for the next wake-up
+    eStateWarmUp,   // Heating, the status is checked until the output is acceptable
+    eStateRunning,   // Heater stays on, read once per interval
+  }eState_t;
+
+  void account(uint32_t now);
+  bool accept(const DFRobot_ENS160::sSnapshot_t &sample, uint32_t now);
+  void deliver(uint32_t now);
+
+  DFRobot_ENS160 *_sensor;
+  eAccuracyPolicy_t _policy;
+  eState_t _state;
+  uint32_t _interval;
+  uint32_t _lead;   // Heating time before a sample
+  uint32_t _nextSample;
+  uint32_t _nextCheck;
+  uint32_t _onStart;   // Time the heater was switched on
+  uint32_t _lastStep;   // Time accounted up to
+  bool _learn;   // Measure the heating time in this warm-up
+  bool _startUp;   // The initial start-up phase was seen in this warm-up
+  uint32_t _power[3];   // Indexed by ENS160_SLEEP_MODE, ENS160_IDLE_MODE, ENS160_STANDARD_MODE
+  uint32_t _time[3];
+  uint32_t _samples;
+  uint32_t _wakeUps;
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*!
+ * @file DFRobot_ENS160_Sim.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_Sim class
+ * @n Simulated ENS160 register model.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Sim.h"
+
+/* DATA_STATUS register bits */
+#define SIM_STATUS_STATAS    0x80
+#define SIM_STATUS_STATER    0x40
+#define SIM_STATUS_VALIDITY  0x0C
+#define SIM_STATUS_NEWDAT    0x02
+#define SIM_STATUS_NEWGPR    0x01
+
+/* Firmware version reported by ENS160_COMMAND_GET_APPVER */
+#define SIM_FW_MAJOR   5
+#define SIM_FW_MINOR   4
+#define SIM_FW_RELEASE 6
+
+DFRobot_ENS160_Sim::DFRobot_ENS160_Sim(void)
+{
+  _AQI = 1;
+  _TVOC = 0;
+  _ECO2 = 400;
+  _initialStartUp = false;
+  _period = ENS160_SIM_PERIOD;
+  resetSimStats();
+  powerCycle();
+}
+
+void DFRobot_ENS160_Sim::setEnvironment(uint8_t AQI, uint16_t TVOC, uint16_t ECO2)
+{
+  _AQI = AQI;
+  _TVOC = TVOC;
+  _ECO2 = ECO2;
+}
+
+void DFRobot_ENS160_Sim::setInitialStartUp(bool enable)
+{
+  _initialStartUp = enable;
+}
+
+void DFRobot_ENS160_Sim::setPeriod(uint32_t period)
+{
+  _period = period ? period : 1;
+}
+
+void DFRobot_ENS160_Sim::injectReadErrors(uint8_t count)
+{
+  _readErrors = count;
+}
+
+void DFRobot_ENS160_Sim::injectBitError(void)
+{
+  _bitError = true;
+}
+
+void DFRobot_ENS160_Sim::powerCycle(void)
+{
+  memset(_regs, 0, sizeof(_regs));
+  _regs[ENS160_PART_ID_REG] = ENS160_PART_ID & 0xFF;   // Little endian
+  _regs[ENS160_PART_ID_REG + 1] = ENS160_PART_ID >> 8;
+  _regs[ENS160_DATA_STATUS_REG] = eInvalidOutput << 2;
+  _misr = 0;
+  _readErrors = 0;
+  _bitError = false;
+  _modeStart = 0;
+  _lastConversion = 0;
+}
+
+void DFRobot_ENS160_Sim::getSimStats(sSimStats_t *stats)
+{
+  if(NULL != stats) {
+    *stats = _stats;
+  }
+}
+
+void DFRobot_ENS160_Sim::resetSimStats(void)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+uint8_t DFRobot_ENS160_Sim::peekReg(uint8_t reg)
+{
+  update();
+  return (reg < ENS160_SIM_REG_NUM) ? _regs[reg] : 0;
+}
+
+uint32_t DFRobot_ENS160_Sim::getConversionTime(void)
+{
+  update();
+  return _lastConversion;
+}
+
+/***************** Register model ******************************/
+
+uint8_t DFRobot_ENS160_Sim::simMISR(uint8_t data)
+{
+  uint8_t misr_xor = ((_misr << 1) ^ data) & 0xFF;
+  _misr = (_misr & 0x80) ? (misr_xor ^ POLY) : misr_xor;
+  return _misr;
+}
+
+void DFRobot_ENS160_Sim::update(void)
+{
+  if(ENS160_STANDARD_MODE != _regs[ENS160_OPMODE_REG]) {
+    return;
+  }
+  uint32_t now = millis();
+  uint32_t elapsed = now - _modeStart;
+  uint8_t validity = eNormalOperation;
+  if(_initialStartUp && (elapsed < ENS160_SIM_START_UP_TIME)) {
+    validity = eInitialStartUpPhase;
+  } else if(elapsed < ENS160_SIM_WARM_UP_TIME) {
+    validity = eWarmUpPhase;
+  }
+  if(_initialStartUp && (elapsed >= ENS160_SIM_START_UP_TIME)) {
+    _initialStartUp = false;   // Only once in the sensor's lifetime
+  }
+  _regs[ENS160_DATA_STATUS_REG] = (_regs[ENS160_DATA_STATUS_REG] & ~SIM_STATUS_VALIDITY) | (validity << 2);
+
+  if((uint32_t)(now - _lastConversion) < _period) {
+    return;
+  }
+  _lastConversion = now - ((now - _lastConversion) % _period);   // Keep the conversion phase
+
+  _regs[ENS160_DATA_AQI_REG] = _AQI;
+  _regs[ENS160_DATA_TVOC_REG] = _TVOC & 0xFF;
+  _regs[ENS160_DATA_TVOC_REG + 1] = _TVOC >> 8;
+  _regs[ENS160_DATA_ECO2_REG] = _ECO2 & 0xFF;
+  _regs[ENS160_DATA_ECO2_REG + 1] = _ECO2 >> 8;
+  for(uint8_t i = 0; i < 4; i++) {   // Raw resistance of the four hot plates
+    uint16_t raw = 0x3000 + (i << 10) + (_TVOC & 0x3FF);
+    _regs[ENS160_GPR_READ_REG + 2 * i] = raw & 0xFF;
+    _regs[ENS160_GPR_READ_REG + 2 * i + 1] = raw >> 8;
+  }
+  _regs[ENS160_DATA_STATUS_REG] |= (SIM_STATUS_NEWDAT | SIM_STATUS_NEWGPR);
+}
+
+void DFRobot_ENS160_Sim::setOPMode(uint8_t mode)
+{
+  uint8_t *status = &_regs[ENS160_DATA_STATUS_REG];
+  switch(mode) {
+  case ENS160_SIM_RESET_MODE:
+    powerCycle();
+    break;
+  case ENS160_SLEEP_MODE:
+  case ENS160_IDLE_MODE:
+    _regs[ENS160_OPMODE_REG] = mode;
+    *status &= ~(SIM_STATUS_STATAS | SIM_STATUS_STATER);
+    break;
+  case ENS160_STANDARD_MODE:
+    if(ENS160_STANDARD_MODE != _regs[ENS160_OPMODE_REG]) {
+      _modeStart = millis();
+      _lastConversion = _modeStart;
+    }
+    _regs[ENS160_OPMODE_REG] = mode;
+    *status = (*status & ~SIM_STATUS_STATER) | SIM_STATUS_STATAS;
+    break;
+  default:
+    *status |= SIM_STATUS_STATER;   // Invalid operating mode
+    break;
+  }
+}
+
+void DFRobot_ENS160_Sim::runCommand(uint8_t cmd)
+{
+  if(ENS160_IDLE_MODE != _regs[ENS160_OPMODE_REG]) {
+    return;   // Commands are only actioned in IDLE mode
+  }
+  if(ENS160_COMMAND_GET_APPVER == cmd) {
+    _regs[ENS160_GPR_READ_REG + 4] = SIM_FW_MAJOR;
+    _regs[ENS160_GPR_READ_REG + 5] = SIM_FW_MINOR;
+    _regs[ENS160_GPR_READ_REG + 6] = SIM_FW_RELEASE;
+    _regs[ENS160_DATA_STATUS_REG] |= SIM_STATUS_NEWGPR;
+  } else if(ENS160_COMMAND_CLRGPR == cmd) {
+    memset(&_regs[ENS160_GPR_READ_REG], 0, 8);
+    _regs[ENS160_DATA_STATUS_REG] &= ~SIM_STATUS_NEWGPR;
+  }
+}
+
+void DFRobot_ENS160_Sim::writeReg(uint8_t reg, const void* pBuf, size_t size)
+{
+  const uint8_t *_pBuf = (const uint8_t *)pBuf;
+  update();
+  _stats.writeTransactions++;
+  _stats.bytesWritten += size;
+  _stats.wireBytes += 2 + size;   // Address(W), register address, data
+
+  for(size_t i = 0; i < size; i++) {
+    size_t addr = reg + i;
+    if(ENS160_OPMODE_REG == addr) {
+      setOPMode(_pBuf[i]);
+    } else if(ENS160_COMMAND_REG == addr) {
+      runCommand(_pBuf[i]);
+    } else if((ENS160_CONFIG_REG == addr) ||
+              ((addr >= ENS160_TEMP_IN_REG) && (addr < ENS160_TEMP_IN_REG + 4))) {
+      _regs[addr] = _pBuf[i];
+      if(addr >= ENS160_TEMP_IN_REG) {   // DATA_T and DATA_RH report the compensation values in use
+        _regs[ENS160_DATA_T_REG + (addr - ENS160_TEMP_IN_REG)] = _pBuf[i];
+      }
+    } else if((addr >= ENS160_GPR_WRITE_REG) && (addr < ENS160_GPR_READ_REG)) {
+      _regs[addr] = _pBuf[i];
+    }
+  }
+}
+
+size_t DFRobot_ENS160_Sim::readReg(uint8_t reg, void* pBuf, size_t size)
+{
+  uint8_t *_pBuf = (uint8_t *)pBuf;
+  update();
+  _stats.readTransactions++;
+  if(_readErrors) {
+    _readErrors--;
+    _stats.wireBytes += 1;   // Address(W) not acknowledged
+    return 0;
+  }
+  _stats.bytesRead += size;
+  _stats.wireBytes += 3 + size;   // Address(W), register address, address(R), data
+
+  for(size_t i = 0; i < size; i++) {
+    size_t addr = reg + i;
+    uint8_t data = (addr < ENS160_SIM_REG_NUM) ? _regs[addr] : 0;
+    _pBuf[i] = data;
+    if((addr >= ENS160_DATA_STATUS_REG) && (addr < ENS160_DATA_MISR_REG)) {
+      simMISR(data);
+      if(_bitError) {
+        _bitError = false;
+        _pBuf[i] ^= 0x10;   // Corrupted on the wire
+      }
+      if(addr > ENS160_DATA_STATUS_REG) {
+        _regs[ENS160_DATA_STATUS_REG] &= ~SIM_STATUS_NEWDAT;   // Cleared at the first DATA_x read
+      }
+    } else if(ENS160_DATA_MISR_REG == addr) {
+      _pBuf[i] = _misr;   // Reading DATA_MISR does not change it
+    } else if(addr >= ENS160_GPR_READ_REG && addr < ENS160_SIM_REG_NUM) {
+      _regs[ENS160_DATA_STATUS_REG] &= ~SIM_STATUS_NEWGPR;
+    }
+  }
+  return size;
+}
@@ -0,0 +1,169 @@
+/*!
+ * @file  DFRobot_ENS160_Sim.h
+ * @brief  Define infrastructure of DFRobot_ENS160_Sim class
+ * @details  Simulated ENS160: readReg/writeReg work on an in-memory register model of the chip instead of
+ * @n        a bus, covering OPMODE transitions, STATUS validity phases, the DATA_ registers, MISR and GPR.
+ * @n        Every transaction is counted, so the bus cost of each API can be measured without hardware.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_SIM_H__
+#define __DFRobot_ENS160_SIM_H__
+
+#include "DFRobot_ENS160.h"
+
+#define ENS160_SIM_REG_NUM        0x50   ///< Size of the simulated register space (PART_ID..GPR_READ)
+#define ENS160_SIM_RESET_MODE     uint8_t(0xF0)   ///< OPMODE value that resets the chip
+#define ENS160_SIM_PERIOD         1000   ///< Conversion period in STANDARD mode, unit: ms
+#define ENS160_SIM_WARM_UP_TIME   180000   ///< Duration of the Warm-Up phase after entering STANDARD mode, unit: ms
+#define ENS160_SIM_START_UP_TIME  3600000   ///< Duration of the Initial Start-Up phase, unit: ms
+
+class DFRobot_ENS160_Sim:public DFRobot_ENS160
+{
+public:
+  /**
+   * @struct sSimStats_t
+   * @brief Bus traffic counted by the simulated sensor
+   * @note wireBytes counts the bytes an I2C bus would carry: address bytes, register address and data
+   */
+  typedef struct
+  {
+    uint32_t   readTransactions; /**< Number of readReg() calls */
+    uint32_t   writeTransactions; /**< Number of writeReg() calls */
+    uint32_t   bytesRead; /**< Data bytes returned by readReg() */
+    uint32_t   bytesWritten; /**< Data bytes passed to writeReg() */
+    uint32_t   wireBytes; /**< Bytes on the wire, including I2C address and register address bytes */
+  } sSimStats_t;
+
+public:
+  /**
+   * @fn DFRobot_ENS160_Sim
+   * @brief Constructor, the simulated chip starts in DEEP SLEEP mode like after power-on
+   * @return None
+   */
+  DFRobot_ENS160_Sim(void);
+
+  /**
+   * @fn setEnvironment
+   * @brief Set the values the simulated chip reports at its next conversions
+   * @param AQI Air quality index, range: 1-5
+   * @param TVOC TVOC concentration, unit: ppb
+   * @param ECO2 CO2 equivalent concentration, unit: ppm
+   * @return None
+   */
+  void setEnvironment(uint8_t AQI, uint16_t TVOC, uint16_t ECO2);
+
+  /**
+   * @fn setInitialStartUp
+   * @brief Select whether the simulated chip goes through the Initial Start-Up phase (first hour of its lifetime)
+   * @param enable true: Initial Start-Up phase; false: only the Warm-Up phase (default)
+   * @return None
+   */
+  void setInitialStartUp(bool enable);
+
+  /**
+   * @fn setPeriod
+   * @brief Set the conversion period in STANDARD mode, e.g. to simulate the tolerance of the chip oscillator
+   * @param period unit: ms, ENS160_SIM_PERIOD by default
+   * @return None
+   */
+  void setPeriod(uint32_t period);
+
+  /**
+   * @fn injectReadErrors
+   * @brief Make the next readReg() calls fail and return 0
+   * @param count Number of failing reads
+   * @return None
+   */
+  void injectReadErrors(uint8_t count);
+
+  /**
+   * @fn injectBitError
+   * @brief Flip one bit in the next byte read from a DATA_ register, the chip side MISR is not affected
+   * @return None
+   */
+  void injectBitError(void);
+
+  /**
+   * @fn powerCycle
+   * @brief Simulate a power loss of the chip (e.g. brown-out), all registers return to their defaults
+   * @return None
+   */
+  void powerCycle(void);
+
+  /**
+   * @fn getSimStats
+   * @brief Get the bus traffic counted since the last resetSimStats()
+   * @param stats Storage for the counters
+   * @return None
+   */
+  void getSimStats(sSimStats_t *stats);
+
+  /**
+   * @fn resetSimStats
+   * @brief Clear the bus traffic counters
+   * @return None
+   */
+  void resetSimStats(void);
+
+  /**
+   * @fn peekReg
+   * @brief Get a register of the model without counting a transaction or causing side effects
+   * @param reg Register address
+   * @return Register value
+   */
+  uint8_t peekReg(uint8_t reg);
+
+  /**
+   * @fn getConversionTime
+   * @brief Get when the last conversion set NEWDAT, without counting a transaction
+   * @return millis() of the conversion
+   */
+  uint32_t getConversionTime(void);
+
+protected:
+  /**
+   * @fn writeReg
+   * @brief Write the register model
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be written
+   * @param size Length of data to be written
+   * @return None
+   */
+  virtual void writeReg(uint8_t reg, const void* pBuf, size_t size);
+
+  /**
+   * @fn readReg
+   * @brief Read the register model
+   * @param reg  Register address 8bits
+   * @param pBuf Storage and buffer for data to be read
+   * @param size Length of data to be read
+   * @return Return the read length, returning 0 means reading failed
+   */
+  virtual size_t readReg(uint8_t reg, void* pBuf, size_t size);
+
+private:
+  void update(void);
+  void setOPMode(uint8_t mode);
+  void runCommand(uint8_t cmd);
+  uint8_t simMISR(uint8_t data);
+
+  uint8_t _regs[ENS160_SIM_REG_NUM];
+  uint8_t _misr;   // Chip side MISR
+  uint8_t _AQI;
+  uint16_t _TVOC;
+  uint16_t _ECO2;
+  bool _initialStartUp;
+  uint32_t _period;   // Conversion period, unit: ms
+  uint8_t _readErrors;
+  bool _bitError;
+  uint32_t _modeStart;   // millis() when STANDARD mode was entered
+  uint32_t _lastConversion;   // millis() of the last conversion
+  sSimStats_t _stats;
+};
+
+#endif
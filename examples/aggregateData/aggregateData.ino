@@ -0,0 +1,79 @@
+/*!
+ * @file  aggregateData.ino
+ * @brief  Aggregate the sensor data over one-minute windows (use 3.3V main controller for Fermion version)
+ * @details  The sensor is read once per second, min/max/mean/median/EMA of AQI, TVOC and eCO2 are
+ * @n        printed once per minute instead of every sample.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Aggregator.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+/* One-minute windows, EMA weight 1/8 */
+DFRobot_ENS160_Aggregator aggregator(/*window=*/60000, /*emaShift=*/3);
+
+void printChannel(const char *name, const DFRobot_ENS160_Aggregator::sChannelAggregate_t &ch)
+{
+  Serial.print(name);
+  Serial.print(" min ");
+  Serial.print(ch.min);
+  Serial.print(", max ");
+  Serial.print(ch.max);
+  Serial.print(", mean ");
+  Serial.print(ch.mean);
+  Serial.print(", median ");
+  Serial.print(ch.median);
+  Serial.print(", EMA ");
+  Serial.println(ch.ema);
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+}
+
+void loop()
+{
+  DFRobot_ENS160::sSnapshot_t snapshot;
+
+  if(NO_ERR == ENS160.readSnapshot(&snapshot)){
+    if(aggregator.update(snapshot, millis())){
+      DFRobot_ENS160_Aggregator::sAggregate_t record;
+      aggregator.getAggregate(&record);
+      Serial.print("Window of ");
+      Serial.print(record.count);
+      Serial.println(" samples :");
+      printChannel("AQI ", record.AQI);
+      printChannel("TVOC", record.TVOC);
+      printChannel("eCO2", record.ECO2);
+      Serial.println();
+    }
+  }
+  delay(1000);
+}
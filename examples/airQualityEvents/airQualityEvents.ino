@@ -0,0 +1,82 @@
+/*!
+ * @file  airQualityEvents.ino
+ * @brief  Only report when the air quality changes meaningfully (use 3.3V main controller for Fermion version)
+ * @details  AQI band changes, the eCO2 levels 600/800/1000/1500 ppm (50 ppm hysteresis) and TVOC rising or
+ * @n        falling faster than 200 ppb/min are watched on every sample. The sensor is read once per second,
+ * @n        but the report (here the serial port, in an application the radio) only runs when an event fired.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Events.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+DFRobot_ENS160_Events events;
+int aqiRule, eco2Rule, tvocRule;
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+
+  events.attach(&ENS160);   // Every readSnapshot() now checks the rules
+  aqiRule = events.addAQIBand();
+  eco2Rule = events.addECO2Levels(/*hysteresis=*/50);
+  tvocRule = events.addRateLimit(DFRobot_ENS160_Events::eChannelTVOC, /*limit=*/200, /*hysteresis=*/50);
+}
+
+void loop()
+{
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  ENS160.readSnapshot(&snapshot);
+
+  if(events.checkWake()){
+    DFRobot_ENS160_Events::sEvent_t event;
+    while(events.readEvent(&event)){
+      if(aqiRule == event.rule){
+        Serial.print("AQI changed to ");
+        Serial.println(event.value);
+      }else if(eco2Rule == event.rule){
+        Serial.print("eCO2 level ");
+        Serial.print(event.from);
+        Serial.print(" -> ");
+        Serial.print(event.to);
+        Serial.print(" at ");
+        Serial.print(event.value);
+        Serial.println(" ppm");
+      }else if(tvocRule == event.rule){
+        Serial.print("TVOC ");
+        Serial.print((DFRobot_ENS160_Events::eRateRising == event.to) ? "rising" :
+                     (DFRobot_ENS160_Events::eRateFalling == event.to) ? "falling" : "steady");
+        Serial.print(", ");
+        Serial.print(event.value);
+        Serial.println(" ppb/min");
+      }
+    }
+  }
+  delay(1000);
+}
@@ -0,0 +1,67 @@
+/*!
+ * @file  benchmark.ino
+ * @brief  Measure what a sample costs on this board and bus (use 3.3V main controller for Fermion version)
+ * @details  Prints one CSV line per case: microseconds per getter call, samples per second of the getters
+ * @n        and of readSnapshot(), register transactions and bytes on the wire per sample, and the time
+ * @n        begin() and setPWRMode() block. Set LABEL to the library version, board and clock, and copy
+ * @n        the output into a file to compare runs.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Benchmark.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#define ITERATIONS   200   // Operations per case
+#define BUS_CLOCK    100000   // I2C or SPI clock, unit: Hz
+
+#ifdef  I2C_COMMUNICATION
+  #define LABEL   "v1.0.1-i2c-100k"
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_Metered<DFRobot_ENS160_I2C> ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  #define LABEL   "v1.0.1-spi-100k"
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_Metered<DFRobot_ENS160_SPI> ENS160(&SPI, csPin, BUS_CLOCK);
+#endif
+
+void printLine(const char *line)
+{
+  Serial.println(line);
+}
+
+DFRobot_ENS160_Benchmark benchmark(&ENS160, ENS160.getMeter(), printLine);
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+#ifdef  I2C_COMMUNICATION
+  Wire.setClock(BUS_CLOCK);
+#else
+  ENS160.setWireOverhead(ENS160_BENCH_SPI_OVERHEAD, ENS160_BENCH_SPI_OVERHEAD);
+#endif
+
+  benchmark.setLabel(LABEL);
+  benchmark.printHeader();
+  benchmark.run(ITERATIONS);
+}
+
+void loop()
+{
+}
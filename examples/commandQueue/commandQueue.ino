@@ -0,0 +1,86 @@
+/*!
+ * @file  commandQueue.ino
+ * @brief  Read the firmware version through the non-blocking command pipeline (use 3.3V main controller for Fermion version)
+ * @details  GET_APPVER is queued right after beginAsync(), so it runs in the same start-up phase as the
+ * @n        mode and config writes; the result is handed to a callback while loop() keeps running.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+void onCommandDone(uint8_t command, int result, const uint8_t *gpr)
+{
+  if(NO_ERR != result){
+    Serial.print("Command failed : ");
+    Serial.println(result);
+    return;
+  }
+  if(ENS160_COMMAND_GET_APPVER == command){
+    DFRobot_ENS160::sAppVersion_t version;
+    DFRobot_ENS160::decodeAppVersion(gpr, &version);
+    Serial.print("Firmware version : ");
+    Serial.print(version.major);
+    Serial.print(".");
+    Serial.print(version.minor);
+    Serial.print(".");
+    Serial.println(version.release);
+  }
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor without waiting for the mode and config switches
+  while( NO_ERR != ENS160.beginAsync() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+
+  ENS160.queueCommand(ENS160_COMMAND_GET_APPVER, onCommandDone);
+}
+
+void loop()
+{
+  static uint32_t lastRead = 0;
+
+  // Drives the mode switches and the command, calls onCommandDone() when the answer is there
+  if(!ENS160.poll()){
+    return;
+  }
+
+  if((millis() - lastRead) >= 1000){
+    lastRead = millis();
+    DFRobot_ENS160::sSnapshot_t snapshot;
+    if(NO_ERR == ENS160.readSnapshot(&snapshot)){
+      Serial.print("AQI : ");
+      Serial.print(snapshot.AQI);
+      Serial.print(", TVOC : ");
+      Serial.print(snapshot.TVOC);
+      Serial.print(" ppb, eCO2 : ");
+      Serial.print(snapshot.ECO2);
+      Serial.println(" ppm");
+    }
+  }
+}
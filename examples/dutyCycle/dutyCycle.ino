@@ -0,0 +1,83 @@
+/*!
+ * @file  dutyCycle.ino
+ * @brief  Report one sample every 10 minutes with the sensor asleep in between (use 3.3V main controller for Fermion version)
+ * @details  The scheduler switches the heater on shortly before each sample is due, reads the sample once
+ * @n        the output is valid and puts the sensor back into DEEP SLEEP mode. The heating time is learned
+ * @n        from the validity flag. Time per mode and the estimated sensor energy are printed with every sample.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Scheduler.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+DFRobot_ENS160_Scheduler scheduler(&ENS160);
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+
+  /**
+   * eAccuracyValid: only samples in normal operation, the heater runs through the whole warm-up phase
+   * eAccuracyRelaxed: also warm-up samples, the heater runs for a few seconds only
+   */
+  scheduler.begin(/*interval=*/600000, DFRobot_ENS160_Scheduler::eAccuracyValid);
+}
+
+void loop()
+{
+  DFRobot_ENS160::sSnapshot_t snapshot;
+
+  if(scheduler.step(&snapshot)){
+    DFRobot_ENS160_Scheduler::sEnergyStats_t stats;
+    scheduler.getEnergyStats(&stats);
+
+    Serial.print("AQI : ");
+    Serial.print(snapshot.AQI);
+    Serial.print(", TVOC : ");
+    Serial.print(snapshot.TVOC);
+    Serial.print(" ppb, eCO2 : ");
+    Serial.print(snapshot.ECO2);
+    Serial.println(" ppm");
+
+    Serial.print("Sleep ");
+    Serial.print(stats.sleepTime / 1000);
+    Serial.print(" s, standard ");
+    Serial.print(stats.standardTime / 1000);
+    Serial.print(" s, heating before a sample ");
+    Serial.print(stats.warmUpTime / 1000);
+    Serial.print(" s, energy ");
+    Serial.print(stats.energy / 1000);
+    Serial.println(" J");
+    Serial.println();
+  }
+
+  /* A low-power host would sleep here for scheduler.getSleepTime() ms */
+  uint32_t sleepTime = scheduler.getSleepTime();
+  delay((sleepTime > 1000) ? 1000 : sleepTime);
+}
@@ -0,0 +1,111 @@
+/*!
+ * @file  encodeSamples.ino
+ * @brief  Encode samples into compact blocks for logging or radio uplink
+ * @details  A synthetic one-hour trace (one sample per second) is encoded block by block, every block is
+ * @n        decoded again and compared with the input, then the compression ratio and the encode/decode
+ * @n        time are printed. No sensor is needed; for real data fill sCodecSample_t from readSnapshot().
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Codec.h>
+
+#define TRACE_LENGTH   3600   // Samples in the trace
+#define BLOCK_SIZE     64   // Size of one block, e.g. a LoRa payload
+
+/* Size of one sample written as plain binary: timestamp, status, AQI, TVOC, eCO2, temperature, humidity */
+#define RAW_SAMPLE_SIZE   14
+
+uint8_t block[BLOCK_SIZE];
+sCodecSample_t pending[ENS160_CODEC_MAX_SAMPLES];   // Samples of the current block, kept for the check
+
+DFRobot_ENS160_Encoder encoder;
+DFRobot_ENS160_Decoder decoder;
+
+uint32_t encodedBytes = 0, blocks = 0, errors = 0;
+uint32_t encodeTime = 0, decodeTime = 0;
+
+/* Slowly varying values with some sensor noise and an occasional late sample */
+void makeSample(uint16_t i, sCodecSample_t *s)
+{
+  static uint32_t timestamp = 0;
+  timestamp += 1000 + ((random(10) == 0) ? random(30) : 0);
+  s->timestamp = timestamp;
+  s->status = 0x81;
+  s->AQI = 1 + (i / 900);
+  s->TVOC = 120 + (i / 10) + random(4);
+  s->ECO2 = 450 + (i / 4) + random(3);
+  s->temp = 2500 + (i / 360);
+  s->hum = 4500 - (i / 120);
+}
+
+/* Decode the block and compare it with the samples that went in */
+void checkBlock(uint8_t count)
+{
+  sCodecSample_t out;
+  uint8_t n = 0;
+  uint32_t start = micros();
+  decoder.begin(block, encoder.getLength());
+  while(decoder.next(&out)) {
+    if(memcmp(&out, &pending[n], sizeof(out)) != 0) {
+      errors++;
+    }
+    n++;
+  }
+  decodeTime += micros() - start;
+  if(n != count) {
+    errors++;
+  }
+  encodedBytes += encoder.getLength();
+  blocks++;
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  randomSeed(1);
+
+  sCodecSample_t s;
+  uint8_t count = 0;
+  encoder.begin(block, sizeof(block), ENS160_CODEC_TEMP_HUM);
+  for(uint16_t i = 0; i < TRACE_LENGTH; i++) {
+    makeSample(i, &s);
+    uint32_t start = micros();
+    bool added = encoder.add(s);
+    encodeTime += micros() - start;
+    if(!added) {
+      /* Block full: this is where it would be written to flash or sent */
+      checkBlock(count);
+      encoder.begin(block, sizeof(block), ENS160_CODEC_TEMP_HUM);
+      count = 0;
+      encoder.add(s);
+    }
+    pending[count++] = s;
+  }
+  checkBlock(count);
+
+  Serial.print("Samples: ");
+  Serial.println(TRACE_LENGTH);
+  Serial.print("Blocks: ");
+  Serial.println(blocks);
+  Serial.print("Raw bytes: ");
+  Serial.println((uint32_t)TRACE_LENGTH * RAW_SAMPLE_SIZE);
+  Serial.print("Encoded bytes: ");
+  Serial.println(encodedBytes);
+  Serial.print("Compression ratio: ");
+  Serial.println((float)TRACE_LENGTH * RAW_SAMPLE_SIZE / encodedBytes);
+  Serial.print("Encode time per sample (us): ");
+  Serial.println((float)encodeTime / TRACE_LENGTH);
+  Serial.print("Decode time per sample (us): ");
+  Serial.println((float)decodeTime / TRACE_LENGTH);
+  Serial.print("Round-trip errors: ");
+  Serial.println(errors);
+}
+
+void loop()
+{
+  delay(1000);
+}
@@ -0,0 +1,61 @@
+/*!
+ * @file  fastDriver.ino
+ * @brief  Compare the template driver DFRobot_ENS160_Fast with the virtual DFRobot_ENS160_I2C (use 3.3V main controller for Fermion version)
+ * @details  Both drivers read the same sensor, the time per call and the object size (RAM) are printed.
+ * @n        To compare the flash size, build this sketch once with USE_FAST_DRIVER and once without,
+ * @n        only the selected driver is then linked for the measured loop.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Fast.h>
+
+#define USE_FAST_DRIVER  // Comment out this line to measure the virtual driver
+
+#ifdef USE_FAST_DRIVER
+  DFRobot_ENS160_Fast<DFRobot_ENS160_I2CBus> ENS160(DFRobot_ENS160_I2CBus(&Wire, /*I2CAddr*/ 0x53));
+  #define DRIVER_NAME "DFRobot_ENS160_Fast"
+#else
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+  #define DRIVER_NAME "DFRobot_ENS160_I2C"
+#endif
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.print(DRIVER_NAME);
+  Serial.print(" begin ok! Object size (bytes) : ");
+  Serial.println(sizeof(ENS160));
+}
+
+void loop()
+{
+  const uint16_t calls = 1000;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  uint32_t start;
+
+  start = micros();
+  for(uint16_t i = 0; i < calls; i++){
+    ENS160.getAQI();
+  }
+  Serial.print("getAQI (us/call) : ");
+  Serial.println((micros() - start) / calls);
+
+  start = micros();
+  for(uint16_t i = 0; i < calls; i++){
+    ENS160.readSnapshot(&snapshot);
+  }
+  Serial.print("readSnapshot (us/call) : ");
+  Serial.println((micros() - start) / calls);
+
+  Serial.println();
+  delay(5000);
+}
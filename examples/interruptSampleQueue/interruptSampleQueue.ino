@@ -0,0 +1,93 @@
+/*!
+ * @file  interruptSampleQueue.ino
+ * @brief  Queue the sensor data through interrupt (Use 3.3V main controller for Fermion version; this example is only applicable to Fermion version)
+ * @details  Every data ready interrupt is turned into a timestamped sample in a queue, so a slow loop()
+ * @n        (e.g. waiting for an uplink) does not drop samples, it drains them in batches.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-27
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_SampleQueue.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+/* Queue of 16 samples */
+DFRobot_ENS160_SampleQueue<16> queue(&ENS160);
+
+/* External interrupt, only records the time of the new data */
+void interrupt()
+{
+  queue.onDataReady();
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+
+  #if defined(ESP32) || defined(ESP8266)
+    // D4 pin is used as interrupt pin by default, other non-conflicting pins can also be selected as external interrupt pins.
+    attachInterrupt(digitalPinToInterrupt(D4)/* Query the interrupt number of the D4 pin */, interrupt, RISING);
+  #elif defined(ARDUINO_SAM_ZERO)
+    // Pin 5 is used as interrupt pin by default, other non-conflicting pins can also be selected as external interrupt pins
+    attachInterrupt(digitalPinToInterrupt(5)/* Query the interrupt number of the 5 pin */, interrupt, RISING);
+  #endif
+
+  ENS160.setINTMode(ENS160.eINTModeEN | 
+                    ENS160.eINTPinPP | 
+                    ENS160.eINTPinActiveHigh);
+}
+
+void loop()
+{
+  static uint32_t lastUplink = 0;
+
+  // Deferred read of the pending data ready interrupt, call it as often as possible
+  queue.service();
+
+  // The slow part of the application, e.g. an uplink every 10 seconds
+  if(millis() - lastUplink >= 10000){
+    lastUplink = millis();
+
+    DFRobot_ENS160::sTimedSnapshot_t batch[16];
+    uint8_t num = queue.drain(batch, 16);
+    for(uint8_t i = 0; i < num; i++){
+      Serial.print(batch[i].timestamp);
+      Serial.print(" ms : AQI ");
+      Serial.print(batch[i].data.AQI);
+      Serial.print(", TVOC ");
+      Serial.print(batch[i].data.TVOC);
+      Serial.print(" ppb, eCO2 ");
+      Serial.print(batch[i].data.ECO2);
+      Serial.println(" ppm");
+    }
+    Serial.print("Overrun : ");
+    Serial.print(queue.getOverrunCount());
+    Serial.print(", missed : ");
+    Serial.println(queue.getMissedCount());
+    Serial.println();
+  }
+}
@@ -0,0 +1,66 @@
+/*!
+ * @file  multiSensor.ino
+ * @brief  Poll several sensors sharing the I2C and SPI buses (use 3.3V main controller for Fermion version)
+ * @details  Two sensors on one I2C bus (SDO pin to GND and to VCC) and one on SPI are read once per cycle,
+ * @n        each with a single bus transaction, and the health of every sensor is printed.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Manager.h>
+
+DFRobot_ENS160_I2C sensor0(&Wire, /*I2CAddr*/ 0x52);
+DFRobot_ENS160_I2C sensor1(&Wire, /*I2CAddr*/ 0x53);
+/**
+ * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+ * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+ */
+uint8_t csPin = D3;
+DFRobot_ENS160_SPI sensor2(&SPI, csPin);
+
+DFRobot_ENS160_Manager manager;
+DFRobot_ENS160::sSnapshot_t samples[3];
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  manager.addSensor(&sensor0);
+  manager.addSensor(&sensor1);
+  manager.addSensor(&sensor2);
+
+  // Init all sensors, their mode switch times overlap
+  uint8_t num = manager.begin();
+  Serial.print(num);
+  Serial.println(" sensor(s) begin ok!");
+}
+
+void loop()
+{
+  manager.sweep(samples);
+
+  for(uint8_t i = 0; i < manager.getSensorCount(); i++){
+    DFRobot_ENS160_Manager::sSensorHealth_t health;
+    manager.getHealth(i, &health);
+    Serial.print("Sensor ");
+    Serial.print(i);
+    if(!health.online){
+      Serial.println(" : offline");
+      continue;
+    }
+    Serial.print(" : AQI ");
+    Serial.print(samples[i].AQI);
+    Serial.print(", TVOC ");
+    Serial.print(samples[i].TVOC);
+    Serial.print(" ppb, eCO2 ");
+    Serial.print(samples[i].ECO2);
+    Serial.print(" ppm, errors ");
+    Serial.println(health.errors);
+  }
+
+  Serial.println();
+  delay(1000);
+}
@@ -0,0 +1,69 @@
+/*!
+ * @file  phaseLockedPoll.ino
+ * @brief  Read every new sample a few milliseconds after it is ready, without the INTn pin (use 3.3V main controller for Fermion version)
+ * @details  The poller learns the conversion period and phase from the NEWDAT bit and only reads around
+ * @n        the expected data ready time, about 1.5 bus transactions per sample.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Poller.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+DFRobot_ENS160_Poller poller(&ENS160);
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+
+  poller.begin();
+}
+
+void loop()
+{
+  DFRobot_ENS160::sTimedSnapshot_t sample;
+
+  if(poller.poll(&sample)){
+    DFRobot_ENS160_Poller::sPollStats_t stats;
+    poller.getPollStats(&stats);
+
+    Serial.print(sample.timestamp);
+    Serial.print(" ms, AQI : ");
+    Serial.print(sample.data.AQI);
+    Serial.print(", TVOC : ");
+    Serial.print(sample.data.TVOC);
+    Serial.print(" ppb, eCO2 : ");
+    Serial.print(sample.data.ECO2);
+    Serial.print(" ppm, period : ");
+    Serial.print(stats.period);
+    Serial.print(" us, reads per sample : ");
+    Serial.println((float)stats.transactions / stats.samples);
+  }
+
+  // Other work can run here as long as it takes less than poller.getWaitTime()
+}
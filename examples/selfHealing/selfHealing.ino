@@ -0,0 +1,75 @@
+/*!
+ * @file  selfHealing.ino
+ * @brief  Keep measuring through sensor resets and bus faults (use 3.3V main controller for Fermion version)
+ * @details  With self-healing enabled, readSnapshot() notices when the sensor browned out into DEEP SLEEP,
+ * @n        reports an error or stops answering, initialises it again and restores the power mode,
+ * @n        interrupt config and compensation. Samples that could not be read are marked stale.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  // Init the sensor
+  while( NO_ERR != ENS160.begin() ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.println("Begin ok!");
+
+  ENS160.setTempAndHum(/*temperature=*/25.0, /*humidity=*/50.0);
+  ENS160.setMISRCheck(true);   // Corrupted reads count as faults too
+  ENS160.setSelfHealing(true);
+}
+
+void loop()
+{
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  int ret = ENS160.readSnapshot(&snapshot);
+
+  if(snapshot.stale){
+    Serial.print("stale (error ");
+    Serial.print(ret);
+    Serial.print(ENS160.isRecovering() ? ", recovering) " : ") ");
+  }
+  Serial.print("AQI ");
+  Serial.print(snapshot.AQI);
+  Serial.print(", TVOC ");
+  Serial.print(snapshot.TVOC);
+  Serial.print(" ppb, eCO2 ");
+  Serial.print(snapshot.ECO2);
+  Serial.println(" ppm");
+
+  if(ERR_SENSOR_FAULT == ret){
+    DFRobot_ENS160::sHealthStats_t stats;
+    ENS160.getHealthStats(&stats);
+    Serial.print("faults ");
+    Serial.print(stats.faults);
+    Serial.print(", recoveries ");
+    Serial.println(stats.recoveries);
+  }
+  delay(1000);
+}
@@ -0,0 +1,73 @@
+/*!
+ * @file  simulatedSensor.ino
+ * @brief  Run the driver against the simulated sensor and print the bus cost of every API (no sensor needed)
+ * @details  The simulated sensor counts each register transaction, so the transactions and bytes on the wire
+ * @n        that one sample costs can be compared between the single getters and readSnapshot().
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160_Sim.h>
+
+DFRobot_ENS160_Sim ENS160;
+
+/* Print the traffic counted since the last call, divided by the number of samples */
+void printCost(const char *name, uint16_t samples)
+{
+  DFRobot_ENS160_Sim::sSimStats_t stats;
+  ENS160.getSimStats(&stats);
+  ENS160.resetSimStats();
+
+  Serial.print(name);
+  Serial.print(" : transactions/sample ");
+  Serial.print((float)(stats.readTransactions + stats.writeTransactions) / samples);
+  Serial.print(", wire bytes/sample ");
+  Serial.println((float)stats.wireBytes / samples);
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  ENS160.setEnvironment(/*AQI=*/2, /*TVOC=*/120, /*ECO2=*/650);
+  ENS160.resetSimStats();
+  if(NO_ERR != ENS160.begin()){
+    Serial.println("Simulated sensor begin failed");
+    while(1);
+  }
+  printCost("begin", 1);
+  delay(1100);   // Wait for the first conversion
+}
+
+void loop()
+{
+  const uint16_t samples = 100;
+
+  for(uint16_t i = 0; i < samples; i++){
+    ENS160.getENS160Status();
+    ENS160.getAQI();
+    ENS160.getTVOC();
+    ENS160.getECO2();
+  }
+  printCost("getters", samples);
+
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  for(uint16_t i = 0; i < samples; i++){
+    ENS160.readSnapshot(&snapshot);
+  }
+  printCost("readSnapshot", samples);
+
+  ENS160.setMISRCheck(true);
+  ENS160.resetSimStats();
+  for(uint16_t i = 0; i < samples; i++){
+    ENS160.readSnapshot(&snapshot);
+  }
+  printCost("readSnapshot + MISR", samples);
+  ENS160.setMISRCheck(false);
+
+  Serial.println();
+  delay(5000);
+}
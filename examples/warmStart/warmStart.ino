@@ -0,0 +1,96 @@
+/*!
+ * @file  warmStart.ino
+ * @brief  Keep the sensor warm-up progress across MCU resets (use 3.3V main controller for Fermion version)
+ * @details  The sensor state is saved to EEPROM. After a reset (watchdog, brown-out of the MCU only, new
+ * @n        firmware) beginWarm() checks the sensor registers against the saved state; if they match,
+ * @n        no register is written and data is available at once instead of after a new warm-up.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <DFRobot_ENS160.h>
+#include <EEPROM.h>
+
+#define I2C_COMMUNICATION  //I2C communication. Comment out this line of code if you want to use SPI communication.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+   *   For Fermion version, the default I2C address is 0x53, connect SDO pin to GND and I2C address will be 0x52
+   */
+  DFRobot_ENS160_I2C ENS160(&Wire, /*I2CAddr*/ 0x53);
+#else
+  /**
+   * Set up digital pin according to the on-board pin connected with SPI chip-select pin
+   * csPin Available Pins. For example: ESP32&ESP8266(D3), m0(6)
+   */
+  uint8_t csPin = D3;
+  DFRobot_ENS160_SPI ENS160(&SPI, csPin);
+#endif
+
+#define STATE_ADDR       0   // EEPROM address of the saved state
+#define SAVE_INTERVAL    600000   // EEPROM wears out, save every 10 minutes and when the validity phase changes
+
+DFRobot_ENS160::sWarmState_t state;
+uint32_t lastSave = 0;
+
+void saveState(void)
+{
+  ENS160.getWarmState(&state);
+  EEPROM.put(STATE_ADDR, state);
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.commit();
+#endif
+  lastSave = millis();
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.begin(sizeof(state));
+#endif
+
+  EEPROM.get(STATE_ADDR, state);
+  uint32_t start = millis();
+  /**
+   * Falls back to begin() if the saved state is not valid or does not match the sensor
+   * offTime: time between saving and now, 0 if unknown; pass it if an RTC is available
+   */
+  while( NO_ERR != ENS160.beginWarm(&state, /*offTime=*/0) ){
+    Serial.println("Communication with device failed, please check connection");
+    delay(3000);
+  }
+  Serial.print("Begin ok in ");
+  Serial.print(millis() - start);
+  Serial.print(" ms, sensor heated for ");
+  Serial.print(ENS160.getHeaterOnTime() / 1000);
+  Serial.println(" s");
+  saveState();
+}
+
+void loop()
+{
+  static uint8_t lastValidity = 0xFF;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+
+  if(NO_ERR == ENS160.readSnapshot(&snapshot)){
+    Serial.print("Status : ");
+    Serial.print(snapshot.status.validityFlag);
+    Serial.print(", AQI : ");
+    Serial.print(snapshot.AQI);
+    Serial.print(", TVOC : ");
+    Serial.print(snapshot.TVOC);
+    Serial.print(" ppb, eCO2 : ");
+    Serial.print(snapshot.ECO2);
+    Serial.println(" ppm");
+
+    if((snapshot.status.validityFlag != lastValidity) || ((millis() - lastSave) >= SAVE_INTERVAL)){
+      lastValidity = snapshot.status.validityFlag;
+      saveState();
+    }
+  }
+  delay(1000);
+}
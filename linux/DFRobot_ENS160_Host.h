@@ -0,0 +1,102 @@
+/*!
+ * @file  DFRobot_ENS160_Host.h
+ * @brief  The few Arduino core functions the portable part of the library uses, for Linux host builds
+ * @details  Included by DFRobot_ENS160.h when ARDUINO is not defined. Times come from CLOCK_MONOTONIC.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_HOST_H__
+#define __DFRobot_ENS160_HOST_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#ifdef ENABLE_DBG
+  #include <iostream>
+#endif
+
+#ifndef constrain
+  #define constrain(amt, low, high)   ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+#ifdef ENS160_HOST_FAKE_CLOCK
+/* Unit tests: a virtual clock that only delay(), yield() and the test advance, see linux/tests */
+extern uint64_t ens160FakeMicros;
+#define ENS160_FAKE_YIELD_TIME   10   ///< Time a yield() takes on the virtual clock, unit: us
+
+static inline uint64_t ens160HostMicros(void)
+{
+  return ens160FakeMicros;
+}
+#else
+static inline uint64_t ens160HostMicros(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+/* Wrap around like on the Arduino cores, all time arithmetic of the library is unsigned 32 bits */
+static inline uint32_t millis(void)
+{
+  return (uint32_t)(ens160HostMicros() / 1000);
+}
+
+static inline uint32_t micros(void)
+{
+  return (uint32_t)ens160HostMicros();
+}
+
+#ifdef ENS160_HOST_FAKE_CLOCK
+static inline void delay(uint32_t ms)
+{
+  ens160FakeMicros += (uint64_t)ms * 1000;
+}
+
+static inline void delayMicroseconds(uint32_t us)
+{
+  ens160FakeMicros += us;
+}
+
+static inline void yield(void)
+{
+  ens160FakeMicros += ENS160_FAKE_YIELD_TIME;
+}
+#else
+static inline void delay(uint32_t ms)
+{
+  usleep(ms * 1000);
+}
+
+static inline void delayMicroseconds(uint32_t us)
+{
+  usleep(us);
+}
+
+/* The blocking waits of the library spin on yield(), give the CPU away instead */
+static inline void yield(void)
+{
+  sched_yield();
+}
+#endif
+
+/* No interrupt handlers on the host, the sample queue still needs the calls */
+static inline void noInterrupts(void)
+{
+}
+
+static inline void interrupts(void)
+{
+}
+
+#endif
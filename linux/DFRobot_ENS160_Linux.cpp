@@ -0,0 +1,309 @@
+/*!
+ * @file DFRobot_ENS160_Linux.cpp
+ * @brief  Define the infrastructure DFRobot_ENS160_LinuxI2C and DFRobot_ENS160_LinuxSPI classes
+ * @n Register access through i2c-dev and spidev.
+ * @copyright Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license The MIT License (MIT)
+ * @author [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Linux.h"
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+static int defaultIoctl(int fd, unsigned long request, void *arg)
+{
+  return ioctl(fd, request, arg);
+}
+
+/***************** i2c-dev ******************************/
+
+DFRobot_ENS160_LinuxI2C::DFRobot_ENS160_LinuxI2C(const char *device, uint8_t i2cAddr)
+{
+  _device = device;
+  _fd = -1;
+  _deviceAddr = i2cAddr;
+  _retries = ENS160_LINUX_RETRIES;
+  _ioctl = defaultIoctl;
+}
+
+DFRobot_ENS160_LinuxI2C::~DFRobot_ENS160_LinuxI2C()
+{
+  end();
+}
+
+int DFRobot_ENS160_LinuxI2C::begin(void)
+{
+  if(!open()) {
+    return ERR_DATA_BUS;
+  }
+  return DFRobot_ENS160::begin();
+}
+
+int DFRobot_ENS160_LinuxI2C::beginAsync(void)
+{
+  if(!open()) {
+    return ERR_DATA_BUS;
+  }
+  return DFRobot_ENS160::beginAsync();
+}
+
+int DFRobot_ENS160_LinuxI2C::beginWarm(const sWarmState_t *state, uint32_t offTime)
+{
+  if(!open()) {
+    return ERR_DATA_BUS;
+  }
+  return DFRobot_ENS160::beginWarm(state, offTime);
+}
+
+void DFRobot_ENS160_LinuxI2C::end(void)
+{
+  if(_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+void DFRobot_ENS160_LinuxI2C::setRetries(uint8_t retries)
+{
+  _retries = retries;
+}
+
+void DFRobot_ENS160_LinuxI2C::setIoctl(ens160Ioctl_t func)
+{
+  _ioctl = func ? func : defaultIoctl;
+}
+
+bool DFRobot_ENS160_LinuxI2C::open(void)
+{
+  if(_fd < 0) {
+    _fd = ::open(_device, O_RDWR);
+    if(_fd < 0) {
+      DBG("cannot open the I2C device");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DFRobot_ENS160_LinuxI2C::transfer(struct i2c_msg *msgs, uint32_t num)
+{
+  struct i2c_rdwr_ioctl_data data;
+  data.msgs = msgs;
+  data.nmsgs = num;
+  for(uint8_t i = 0; i <= _retries; i++) {
+    if(_ioctl(_fd, I2C_RDWR, &data) >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DFRobot_ENS160_LinuxI2C::writeReg(uint8_t reg, const void* pBuf, size_t size)
+{
+  if(NULL == pBuf) {
+    DBG("pBuf ERROR!! : null pointer");
+    return;
+  }
+  const uint8_t *_pBuf = (const uint8_t *)pBuf;
+  struct i2c_msg msg;
+  bool ok = (_fd >= 0);
+  BUS_STATS_BEGIN();
+
+  for(size_t offset = 0; ok && (offset < size); offset += ENS160_LINUX_MAX_XFER) {
+    size_t n = size - offset;
+    if(n > ENS160_LINUX_MAX_XFER) {
+      n = ENS160_LINUX_MAX_XFER;
+    }
+    _txBuf[0] = reg + offset;   // The register address auto-increments within a transfer
+    memcpy(&_txBuf[1], &_pBuf[offset], n);
+    msg.addr = _deviceAddr;
+    msg.flags = 0;
+    msg.len = 1 + n;
+    msg.buf = _txBuf;
+    ok = transfer(&msg, 1);
+  }
+  BUS_STATS_END(size, ok);
+}
+
+size_t DFRobot_ENS160_LinuxI2C::readReg(uint8_t reg, void* pBuf, size_t size)
+{
+  if(NULL == pBuf) {
+    DBG("pBuf ERROR!! : null pointer");
+    return 0;
+  }
+  uint8_t *_pBuf = (uint8_t *)pBuf;
+  struct i2c_msg msgs[2];
+  size_t count = 0;
+  BUS_STATS_BEGIN();
+
+  if(_fd >= 0) {
+    while(count < size) {
+      size_t n = size - count;
+      if(n > ENS160_LINUX_MAX_XFER) {
+        n = ENS160_LINUX_MAX_XFER;
+      }
+      // Register address and data in one combined transfer, with a repeated start
+      _txBuf[0] = reg + count;
+      msgs[0].addr = _deviceAddr;
+      msgs[0].flags = 0;
+      msgs[0].len = 1;
+      msgs[0].buf = _txBuf;
+      msgs[1].addr = _deviceAddr;
+      msgs[1].flags = I2C_M_RD;
+      msgs[1].len = n;
+      msgs[1].buf = &_pBuf[count];
+      if(!transfer(msgs, 2)) {
+        break;
+      }
+      count += n;
+    }
+  }
+  BUS_STATS_END(count, size == count);
+  return count;
+}
+
+/***************** spidev ******************************/
+
+DFRobot_ENS160_LinuxSPI::DFRobot_ENS160_LinuxSPI(const char *device, uint32_t clock)
+{
+  _device = device;
+  _fd = -1;
+  _ioctl = defaultIoctl;
+  setClock(clock);
+}
+
+DFRobot_ENS160_LinuxSPI::~DFRobot_ENS160_LinuxSPI()
+{
+  end();
+}
+
+int DFRobot_ENS160_LinuxSPI::begin(void)
+{
+  if(!open()) {
+    return ERR_DATA_BUS;
+  }
+  return DFRobot_ENS160::begin();
+}
+
+int DFRobot_ENS160_LinuxSPI::beginAsync(void)
+{
+  if(!open()) {
+    return ERR_DATA_BUS;
+  }
+  return DFRobot_ENS160::beginAsync();
+}
+
+int DFRobot_ENS160_LinuxSPI::beginWarm(const sWarmState_t *state, uint32_t offTime)
+{
+  if(!open()) {
+    return ERR_DATA_BUS;
+  }
+  return DFRobot_ENS160::beginWarm(state, offTime);
+}
+
+void DFRobot_ENS160_LinuxSPI::end(void)
+{
+  if(_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+void DFRobot_ENS160_LinuxSPI::setClock(uint32_t clock)
+{
+  _clock = (clock > ENS160_SPI_MAX_CLOCK) ? ENS160_SPI_MAX_CLOCK : clock;
+}
+
+void DFRobot_ENS160_LinuxSPI::setIoctl(ens160Ioctl_t func)
+{
+  _ioctl = func ? func : defaultIoctl;
+}
+
+bool DFRobot_ENS160_LinuxSPI::open(void)
+{
+  if(_fd >= 0) {
+    return true;
+  }
+  _fd = ::open(_device, O_RDWR);
+  if(_fd < 0) {
+    DBG("cannot open the SPI device");
+    return false;
+  }
+
+  uint8_t mode = SPI_MODE_0;
+  uint8_t bits = 8;
+  if((_ioctl(_fd, SPI_IOC_WR_MODE, &mode) < 0) ||
+     (_ioctl(_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0) ||
+     (_ioctl(_fd, SPI_IOC_WR_MAX_SPEED_HZ, &_clock) < 0)) {
+    DBG("cannot configure the SPI device");
+    end();
+    return false;
+  }
+  return true;
+}
+
+bool DFRobot_ENS160_LinuxSPI::transfer(size_t len)
+{
+  struct spi_ioc_transfer xfer;
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.tx_buf = (unsigned long)_txBuf;
+  xfer.rx_buf = (unsigned long)_rxBuf;
+  xfer.len = len;
+  xfer.speed_hz = _clock;
+  xfer.bits_per_word = 8;
+  return _ioctl(_fd, SPI_IOC_MESSAGE(1), &xfer) >= 0;
+}
+
+void DFRobot_ENS160_LinuxSPI::writeReg(uint8_t reg, const void* pBuf, size_t size)
+{
+  if(NULL == pBuf) {
+    DBG("pBuf ERROR!! : null pointer");
+    return;
+  }
+  const uint8_t *_pBuf = (const uint8_t *)pBuf;
+  bool ok = (_fd >= 0);
+  BUS_STATS_BEGIN();
+
+  for(size_t offset = 0; ok && (offset < size); offset += ENS160_LINUX_MAX_XFER) {
+    size_t n = size - offset;
+    if(n > ENS160_LINUX_MAX_XFER) {
+      n = ENS160_LINUX_MAX_XFER;
+    }
+    _txBuf[0] = ((reg + offset) << 1) & 0xFE;
+    memcpy(&_txBuf[1], &_pBuf[offset], n);
+    ok = transfer(1 + n);
+  }
+  BUS_STATS_END(size, ok);
+}
+
+size_t DFRobot_ENS160_LinuxSPI::readReg(uint8_t reg, void* pBuf, size_t size)
+{
+  if(NULL == pBuf) {
+    DBG("pBuf ERROR!! : null pointer");
+    return 0;
+  }
+  uint8_t *_pBuf = (uint8_t *)pBuf;
+  size_t count = 0;
+  BUS_STATS_BEGIN();
+
+  if(_fd >= 0) {
+    while(count < size) {
+      size_t n = size - count;
+      if(n > ENS160_LINUX_MAX_XFER) {
+        n = ENS160_LINUX_MAX_XFER;
+      }
+      _txBuf[0] = ((reg + count) << 1) | 0x01;
+      memset(&_txBuf[1], 0, n);
+      if(!transfer(1 + n)) {
+        break;
+      }
+      memcpy(&_pBuf[count], &_rxBuf[1], n);
+      count += n;
+    }
+  }
+  BUS_STATS_END(count, size == count);
+  return count;
+}
@@ -0,0 +1,195 @@
+/*!
+ * @file  DFRobot_ENS160_Linux.h
+ * @brief  Define infrastructure of DFRobot_ENS160_LinuxI2C and DFRobot_ENS160_LinuxSPI classes
+ * @details  Register access of the ENS160 from Linux user space: /dev/i2c-N with combined I2C_RDWR
+ * @n        write+read messages, /dev/spidevX.Y with SPI_IOC_MESSAGE burst transfers. Every register
+ * @n        access is one ioctl on preallocated buffers. The ioctl can be replaced with setIoctl(), so
+ * @n        the classes can run against a fake device file without hardware.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-25
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __DFRobot_ENS160_LINUX_H__
+#define __DFRobot_ENS160_LINUX_H__
+
+#include "DFRobot_ENS160.h"
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+
+#define ENS160_LINUX_MAX_XFER   32   ///< Data bytes per ioctl, longer blocks are split (GPR_WRITE, the largest, is 8)
+#define ENS160_LINUX_RETRIES    2   ///< Default number of retries of a failed I2C transfer
+#ifndef ENS160_SPI_CLOCK
+  #define ENS160_SPI_CLOCK       2000000   ///< Default SPI clock, unit: Hz
+  #define ENS160_SPI_MAX_CLOCK   10000000   ///< Maximum SPI clock of the ENS160, unit: Hz
+#endif
+
+/**
+ * @brief ioctl() of the device file, replaceable for testing
+ * @param fd File descriptor of the opened device
+ * @param request I2C_RDWR, SPI_IOC_MESSAGE(1), SPI_IOC_WR_MODE ...
+ * @param arg Argument of the request
+ * @return -1 on failure as ioctl()
+ */
+typedef int (*ens160Ioctl_t)(int fd, unsigned long request, void *arg);
+
+class DFRobot_ENS160_LinuxI2C:public DFRobot_ENS160
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_LinuxI2C
+   * @brief Constructor
+   * @param device I2C bus device file, e.g. "/dev/i2c-1"
+   * @param i2cAddr The I2C address is 0x52 when SDO pin is connected to GND and 0x53 when connected to VCC.
+   * @return None
+   */
+  DFRobot_ENS160_LinuxI2C(const char *device="/dev/i2c-1", uint8_t i2cAddr=0x53);
+  ~DFRobot_ENS160_LinuxI2C();
+
+  /**
+   * @fn begin
+   * @brief Open the device file and init the sensor
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS, also if the device file cannot be opened
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int begin(void);
+
+  /**
+   * @fn beginAsync
+   * @brief Open the device file, non-blocking init function
+   * @return int type, indicates returning init status
+   */
+  virtual int beginAsync(void);
+
+  /**
+   * @fn beginWarm
+   * @brief Open the device file, warm-start init function
+   * @param state State saved by getWarmState()
+   * @param offTime Time between saving the state and this call if known, unit: ms
+   * @return int type, indicates returning init status
+   */
+  virtual int beginWarm(const sWarmState_t *state, uint32_t offTime = 0);
+
+  /**
+   * @fn end
+   * @brief Close the device file
+   * @return None
+   */
+  void end(void);
+
+  /**
+   * @fn setRetries
+   * @brief Set how often a failed transfer is repeated
+   * @param retries Number of retries
+   * @return None
+   */
+  void setRetries(uint8_t retries);
+
+  /**
+   * @fn setIoctl
+   * @brief Replace the ioctl() used for the transfers, e.g. with a shim that emulates the sensor
+   * @param func The function, NULL restores ioctl()
+   * @return None
+   */
+  void setIoctl(ens160Ioctl_t func);
+
+protected:
+  virtual void writeReg(uint8_t reg, const void* pBuf, size_t size);
+  virtual size_t readReg(uint8_t reg, void* pBuf, size_t size);
+
+private:
+  bool open(void);
+  bool transfer(struct i2c_msg *msgs, uint32_t num);
+
+  const char *_device;
+  int _fd;
+  uint8_t _deviceAddr;
+  uint8_t _retries;
+  ens160Ioctl_t _ioctl;
+  uint8_t _txBuf[1 + ENS160_LINUX_MAX_XFER];   // Register address and write data
+};
+
+class DFRobot_ENS160_LinuxSPI:public DFRobot_ENS160
+{
+public:
+  /**
+   * @fn DFRobot_ENS160_LinuxSPI
+   * @brief Constructor
+   * @param device spidev device file, e.g. "/dev/spidev0.0", the chip select is the one of the device
+   * @param clock SPI clock, unit: Hz, limited to ENS160_SPI_MAX_CLOCK (10 MHz)
+   * @return None
+   */
+  DFRobot_ENS160_LinuxSPI(const char *device="/dev/spidev0.0", uint32_t clock=ENS160_SPI_CLOCK);
+  ~DFRobot_ENS160_LinuxSPI();
+
+  /**
+   * @fn begin
+   * @brief Open and configure the device file and init the sensor
+   * @return int type, indicates returning init status
+   * @retval 0 NO_ERROR
+   * @retval -1 ERR_DATA_BUS, also if the device file cannot be opened or configured
+   * @retval -2 ERR_IC_VERSION
+   */
+  virtual int begin(void);
+
+  /**
+   * @fn beginAsync
+   * @brief Open and configure the device file, non-blocking init function
+   * @return int type, indicates returning init status
+   */
+  virtual int beginAsync(void);
+
+  /**
+   * @fn beginWarm
+   * @brief Open and configure the device file, warm-start init function
+   * @param state State saved by getWarmState()
+   * @param offTime Time between saving the state and this call if known, unit: ms
+   * @return int type, indicates returning init status
+   */
+  virtual int beginWarm(const sWarmState_t *state, uint32_t offTime = 0);
+
+  /**
+   * @fn end
+   * @brief Close the device file
+   * @return None
+   */
+  void end(void);
+
+  /**
+   * @fn setClock
+   * @brief Set the SPI clock, it takes effect with the next transfer
+   * @param clock unit: Hz, limited to ENS160_SPI_MAX_CLOCK (10 MHz)
+   * @return None
+   */
+  void setClock(uint32_t clock);
+
+  /**
+   * @fn setIoctl
+   * @brief Replace the ioctl() used for the transfers, e.g. with a shim that emulates the sensor
+   * @param func The function, NULL restores ioctl()
+   * @return None
+   */
+  void setIoctl(ens160Ioctl_t func);
+
+protected:
+  virtual void writeReg(uint8_t reg, const void* pBuf, size_t size);
+  virtual size_t readReg(uint8_t reg, void* pBuf, size_t size);
+
+private:
+  bool open(void);
+  bool transfer(size_t len);
+
+  const char *_device;
+  int _fd;
+  uint32_t _clock;
+  ens160Ioctl_t _ioctl;
+  uint8_t _txBuf[1 + ENS160_LINUX_MAX_XFER];   // Address byte and write data
+  uint8_t _rxBuf[1 + ENS160_LINUX_MAX_XFER];   // Full duplex, the read data follows the address byte
+};
+
+#endif
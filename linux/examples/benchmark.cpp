@@ -0,0 +1,58 @@
+/*!
+ * @file  benchmark.cpp
+ * @brief  Measure the read paths of the driver and print the results as CSV, from a Linux board or the host
+ * @details  Usage: benchmark [device] [address|clock] [iterations] [label]
+ * @n        device "sim" (default) for the simulated sensor, "/dev/i2c-N" or "/dev/spidevX.Y";
+ * @n        address the I2C address (default 0x53) or clock the SPI clock in Hz (default 2000000);
+ * @n        iterations per case (default 1000); label the first CSV column (default the device).
+ * @n        With "sim" the times are the CPU cost of the driver alone, the bytes are those of I2C.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Linux.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_Benchmark.h"
+#include <stdio.h>
+
+static void printLine(const char *line)
+{
+  printf("%s\n", line);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *device = (argc > 1) ? argv[1] : "sim";
+  uint32_t param = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0;
+  uint16_t iterations = (argc > 3) ? strtoul(argv[3], NULL, 0) : 1000;
+  const char *label = (argc > 4) ? argv[4] : device;
+
+  DFRobot_ENS160_Metered<DFRobot_ENS160_Sim> sim;
+  DFRobot_ENS160_Metered<DFRobot_ENS160_LinuxI2C> i2c(device, param ? param : 0x53);
+  DFRobot_ENS160_Metered<DFRobot_ENS160_LinuxSPI> spi(device, param ? param : ENS160_SPI_CLOCK);
+  spi.setWireOverhead(ENS160_BENCH_SPI_OVERHEAD, ENS160_BENCH_SPI_OVERHEAD);
+
+  DFRobot_ENS160 *ENS160 = &i2c;
+  const DFRobot_ENS160_Benchmark::sBenchMeter_t *meter = i2c.getMeter();
+  if(0 == strcmp(device, "sim")) {
+    ENS160 = &sim;
+    meter = sim.getMeter();
+  } else if(strstr(device, "spidev")) {
+    ENS160 = &spi;
+    meter = spi.getMeter();
+  }
+
+  if(NO_ERR != ENS160->begin()) {
+    fprintf(stderr, "Communication with device failed, please check connection\n");
+    return 1;
+  }
+
+  DFRobot_ENS160_Benchmark benchmark(ENS160, meter, printLine);
+  benchmark.setLabel(label);
+  benchmark.printHeader();
+  benchmark.run(iterations);
+  return 0;
+}
@@ -0,0 +1,43 @@
+/*!
+ * @file  getMeasureData.cpp
+ * @brief  Get the sensor data by polling, from a Linux board
+ * @details  Usage: getMeasureData [device] [address]
+ * @n        device "/dev/i2c-N" (default /dev/i2c-1) or "/dev/spidevX.Y", address the I2C address (default 0x53)
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "DFRobot_ENS160_Linux.h"
+#include <stdio.h>
+
+int main(int argc, char *argv[])
+{
+  const char *device = (argc > 1) ? argv[1] : "/dev/i2c-1";
+  uint8_t addr = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0x53;
+  DFRobot_ENS160_LinuxI2C i2c(device, addr);
+  DFRobot_ENS160_LinuxSPI spi(device);
+  DFRobot_ENS160 *ENS160 = strstr(device, "spidev") ? (DFRobot_ENS160 *)&spi : (DFRobot_ENS160 *)&i2c;
+
+  // Init the sensor
+  while( NO_ERR != ENS160->begin() ){
+    printf("Communication with device failed, please check connection\n");
+    delay(3000);
+  }
+  printf("Begin ok!\n");
+
+  ENS160->setPWRMode(ENS160_STANDARD_MODE);
+  ENS160->setTempAndHum(/*temperature=*/25.0, /*humidity=*/50.0);
+
+  while(true){
+    DFRobot_ENS160::sSnapshot_t snapshot;
+    if(NO_ERR == ENS160->readSnapshot(&snapshot)){
+      printf("Sensor operating status : %u, AQI : %u, TVOC : %u ppb, eCO2 : %u ppm\n",
+             snapshot.status.validityFlag, snapshot.AQI, snapshot.TVOC, snapshot.ECO2);
+    }
+    delay(1000);
+  }
+  return 0;
+}
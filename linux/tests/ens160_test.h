@@ -0,0 +1,64 @@
+/*!
+ * @file  ens160_test.h
+ * @brief  Minimal check macros and the virtual clock of the host unit tests
+ * @details  The tests link against the library built with ENS160_HOST_FAKE_CLOCK: time only moves when
+ * @n        the code under test calls delay()/yield() or the test calls advance(), so phases that last
+ * @n        minutes on the chip run in microseconds and every run gives the same result.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __ENS160_TEST_H__
+#define __ENS160_TEST_H__
+
+#include "DFRobot_ENS160.h"
+#include <stdio.h>
+
+static int ens160TestFailures = 0;
+
+#define CHECK(cond)   do { \
+    if(!(cond)) { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      ens160TestFailures++; \
+    } \
+  } while(0)
+
+#define CHECK_EQ(actual, expected)   do { \
+    long _a = (long)(actual); \
+    long _e = (long)(expected); \
+    if(_a != _e) { \
+      printf("%s:%d: %s is %ld, expected %s (%ld)\n", __FILE__, __LINE__, #actual, _a, #expected, _e); \
+      ens160TestFailures++; \
+    } \
+  } while(0)
+
+#define RUN_TEST(fn)   do { \
+    int _before = ens160TestFailures; \
+    fn(); \
+    printf("%s %s\n", (_before == ens160TestFailures) ? "PASS" : "FAIL", #fn); \
+  } while(0)
+
+/**
+ * @fn advance
+ * @brief Move the virtual clock forward
+ * @param ms Time, unit: ms
+ */
+static inline void advance(uint32_t ms)
+{
+  ens160FakeMicros += (uint64_t)ms * 1000;
+}
+
+/**
+ * @fn testResult
+ * @brief Exit code of a test program
+ */
+static inline int testResult(void)
+{
+  printf("%d check(s) failed\n", ens160TestFailures);
+  return ens160TestFailures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,13 @@
+/*!
+ * @file  ens160_test_clock.cpp
+ * @brief  The virtual clock of the host unit tests, see ENS160_HOST_FAKE_CLOCK
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include <stdint.h>
+
+uint64_t ens160FakeMicros = 1000000;   // Not 0, code that uses 0 as "never" must still work
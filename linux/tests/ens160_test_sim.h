@@ -0,0 +1,48 @@
+/*!
+ * @file  ens160_test_sim.h
+ * @brief  The simulated ENS160 of the host unit tests, with its register writes counted
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#ifndef __ENS160_TEST_SIM_H__
+#define __ENS160_TEST_SIM_H__
+
+#include "DFRobot_ENS160_Sim.h"
+
+/* The simulated sensor with the raw register access opened up */
+class TestSim:public DFRobot_ENS160_Sim
+{
+public:
+  using DFRobot_ENS160_Sim::readReg;
+
+  void writeByte(uint8_t reg, uint8_t data)
+  {
+    writeReg(reg, &data, 1);
+  }
+
+  uint8_t idleWrites = 0;   // OPMODE writes of IDLE mode
+  uint8_t modeWrites = 0;   // All OPMODE writes
+  uint8_t configWrites = 0;   // CONFIG writes
+  uint8_t compWrites = 0;   // TEMP_IN/RH_IN writes
+
+  virtual void writeReg(uint8_t reg, const void* pBuf, size_t size)
+  {
+    if(ENS160_OPMODE_REG == reg) {
+      modeWrites++;
+      if(ENS160_IDLE_MODE == *(const uint8_t *)pBuf) {
+        idleWrites++;
+      }
+    } else if(ENS160_CONFIG_REG == reg) {
+      configWrites++;
+    } else if(ENS160_TEMP_IN_REG == reg) {
+      compWrites++;
+    }
+    DFRobot_ENS160_Sim::writeReg(reg, pBuf, size);
+  }
+};
+
+#endif
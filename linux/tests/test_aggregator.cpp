@@ -0,0 +1,78 @@
+/*!
+ * @file  test_aggregator.cpp
+ * @brief  Unit tests of DFRobot_ENS160_Aggregator
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Aggregator.h"
+
+static DFRobot_ENS160::sSnapshot_t sample(uint8_t AQI, uint16_t TVOC, uint16_t ECO2)
+{
+  DFRobot_ENS160::sSnapshot_t s;
+  memset(&s, 0, sizeof(s));
+  s.status.validityFlag = DFRobot_ENS160::eNormalOperation;
+  s.AQI = AQI;
+  s.TVOC = TVOC;
+  s.ECO2 = ECO2;
+  return s;
+}
+
+static void testWindow(void)
+{
+  DFRobot_ENS160_Aggregator agg(1000);
+  DFRobot_ENS160_Aggregator::sAggregate_t record;
+  DFRobot_ENS160::sSnapshot_t invalid = sample(5, 0, 0);
+  invalid.status.validityFlag = DFRobot_ENS160::eInvalidOutput;
+
+  CHECK(!agg.update(sample(1, 100, 400), 0));
+  CHECK(!agg.update(sample(3, 300, 600), 250));
+  CHECK(!agg.update(invalid, 500));
+  CHECK(!agg.update(sample(2, 200, 500), 750));
+  CHECK_EQ(agg.getNextBoundary(), 1000);
+  CHECK(agg.update(sample(2, 200, 500), 2100));   // Closes the first window, skips none
+  CHECK_EQ(agg.getNextBoundary(), 3000);
+
+  agg.getAggregate(&record);
+  CHECK_EQ(record.start, 0);
+  CHECK_EQ(record.count, 3);
+  CHECK_EQ(record.skipped, 1);
+  CHECK_EQ(record.TVOC.min, 100);
+  CHECK_EQ(record.TVOC.max, 300);
+  CHECK_EQ(record.TVOC.mean, 200);
+  CHECK_EQ(record.ECO2.mean, 500);
+}
+
+static void testMedianPerWindow(void)
+{
+  DFRobot_ENS160_Aggregator agg(1000);
+  DFRobot_ENS160_Aggregator::sAggregate_t record;
+
+  for(uint32_t t = 0; t < 1000; t += 50) {
+    agg.update(sample(5, 5000, 5000), t);
+  }
+  // Clean air in the next window: its median must not start from the last one
+  for(uint32_t t = 1000; t < 1250; t += 50) {
+    agg.update(sample(1, 50, 400), t);
+  }
+  CHECK(agg.update(sample(1, 50, 400), 2000));
+
+  agg.getAggregate(&record);
+  CHECK_EQ(record.start, 1000);
+  CHECK_EQ(record.count, 5);
+  CHECK_EQ(record.ECO2.median, 400);
+  CHECK_EQ(record.TVOC.median, 50);
+  CHECK_EQ(record.AQI.median, 1);
+  CHECK(record.ECO2.ema > 400);   // The EMA does carry over
+}
+
+int main(void)
+{
+  RUN_TEST(testWindow);
+  RUN_TEST(testMedianPerWindow);
+  return testResult();
+}
@@ -0,0 +1,112 @@
+/*!
+ * @file  test_benchmark.cpp
+ * @brief  Smoke test of DFRobot_ENS160_Benchmark against the metered simulated sensor
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_Benchmark.h"
+
+#define ITERATIONS   20
+#define MAX_LINES    (DFRobot_ENS160_Benchmark::eBenchCaseNum + 1)
+
+static char lines[MAX_LINES][ENS160_BENCH_LINE_SIZE];
+static uint8_t lineCount = 0;
+
+static void saveLine(const char *line)
+{
+  if(lineCount < MAX_LINES) {
+    snprintf(lines[lineCount], ENS160_BENCH_LINE_SIZE, "%s", line);
+  }
+  lineCount++;
+}
+
+/* The line of a case, NULL if it was not output */
+static const char *findCase(DFRobot_ENS160_Benchmark::eBenchCase_t benchCase)
+{
+  char prefix[32];
+  snprintf(prefix, sizeof(prefix), "sim,%s,", DFRobot_ENS160_Benchmark::getCaseName(benchCase));
+  for(uint8_t i = 0; (i < lineCount) && (i < MAX_LINES); i++) {
+    if(0 == strncmp(lines[i], prefix, strlen(prefix))) {
+      return lines[i];
+    }
+  }
+  return NULL;
+}
+
+/* Check the iterations and the last two columns of a case */
+static void checkCost(DFRobot_ENS160_Benchmark::eBenchCase_t benchCase, const char *transactions, const char *wireBytes)
+{
+  char name[32], perOp[16], perSecond[16], trans[16], bytes[16];
+  unsigned iterations = 0;
+  unsigned long total = 0;
+  const char *line = findCase(benchCase);
+  CHECK(NULL != line);
+  if(NULL == line) {
+    return;
+  }
+  CHECK_EQ(sscanf(line, "sim,%31[^,],%u,%lu,%15[^,],%15[^,],%15[^,],%15s", name, &iterations, &total,
+                  perOp, perSecond, trans, bytes), 7);
+  CHECK_EQ(iterations, ITERATIONS);
+  if(strcmp(trans, transactions) || strcmp(bytes, wireBytes)) {
+    printf("%s: %s transactions and %s wire bytes per op, expected %s and %s\n", name, trans, bytes,
+           transactions, wireBytes);
+    CHECK(false);
+  }
+}
+
+static void testRun(void)
+{
+  DFRobot_ENS160_Metered<DFRobot_ENS160_Sim> sim;
+  CHECK_EQ(sim.begin(), NO_ERR);
+  DFRobot_ENS160_Benchmark benchmark(&sim, sim.getMeter(), saveLine);
+  benchmark.setLabel("sim");
+  lineCount = 0;
+  benchmark.printHeader();
+  benchmark.run(ITERATIONS);
+
+  CHECK_EQ(lineCount, MAX_LINES);
+  CHECK_EQ(strcmp(lines[0], "label,case,iterations,total_us,us_per_op,ops_per_s,transactions_per_op,wire_bytes_per_op"), 0);
+  for(uint8_t i = 0; i < DFRobot_ENS160_Benchmark::eBenchCaseNum; i++) {
+    CHECK(NULL != findCase((DFRobot_ENS160_Benchmark::eBenchCase_t)i));
+  }
+
+  // The single transaction reads: I2C overhead 3 + data bytes
+  checkCost(DFRobot_ENS160_Benchmark::eBenchGetStatus, "1.00", "4.00");
+  checkCost(DFRobot_ENS160_Benchmark::eBenchGetAQI, "1.00", "4.00");
+  checkCost(DFRobot_ENS160_Benchmark::eBenchGetTVOC, "1.00", "5.00");
+  checkCost(DFRobot_ENS160_Benchmark::eBenchGetECO2, "1.00", "5.00");
+  checkCost(DFRobot_ENS160_Benchmark::eBenchSnapshot, "1.00", "9.00");
+  // One sample with the getters costs four of them, the MISR check one more read
+  checkCost(DFRobot_ENS160_Benchmark::eBenchGetters, "4.00", "18.00");
+  checkCost(DFRobot_ENS160_Benchmark::eBenchSnapshotMISR, "2.00", "13.00");
+}
+
+static void testNotMetered(void)
+{
+  DFRobot_ENS160_Sim sim;
+  sim.begin();
+  DFRobot_ENS160_Benchmark benchmark(&sim, NULL, saveLine);
+  benchmark.setLabel("sim");
+  lineCount = 0;
+  benchmark.runCase(DFRobot_ENS160_Benchmark::eBenchGetAQI, ITERATIONS);
+  benchmark.runCase(DFRobot_ENS160_Benchmark::eBenchCaseNum, ITERATIONS);   // Unknown case: no line
+  CHECK_EQ(lineCount, 1);
+  const char *line = findCase(DFRobot_ENS160_Benchmark::eBenchGetAQI);
+  CHECK(NULL != line);
+  if(NULL != line) {
+    CHECK_EQ(strcmp(line + strlen(line) - 2, ",,"), 0);   // Cost columns left empty
+  }
+}
+
+int main(void)
+{
+  RUN_TEST(testRun);
+  RUN_TEST(testNotMetered);
+  return testResult();
+}
@@ -0,0 +1,155 @@
+/*!
+ * @file  test_codec.cpp
+ * @brief  Round trip tests of DFRobot_ENS160_Encoder and DFRobot_ENS160_Decoder
+ * @details  With --dump the encoded blocks and the samples they hold are printed as JSON lines instead,
+ * @n        python/raspberrypi/tests/test_codec.py decodes them with the Python decoder.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Codec.h"
+
+#define BLOCK_SIZE   (ENS160_CODEC_HEADER_SIZE + ENS160_CODEC_MAX_SAMPLES * ENS160_CODEC_MAX_RECORD)
+
+typedef struct
+{
+  uint8_t flags;
+  uint8_t count;
+  const sCodecSample_t *samples;
+} sCase_t;
+
+/* Steady rate, a repeated timestamp, delta-of-delta extremes and the 32-bit timestamp wrap */
+static const sCodecSample_t timeSamples[] = {
+  {1000, 0x8C, 1, 0, 400, 0, 0},
+  {2000, 0x8C, 1, 0, 400, 0, 0},
+  {3000, 0x8C, 1, 0, 400, 0, 0},
+  {3000, 0x8C, 1, 0, 400, 0, 0},
+  {0x80000BB8, 0x8C, 1, 0, 400, 0, 0},   // Delta 0x80000000: delta of delta is INT32_MIN
+  {0x80000BB9, 0x8C, 1, 0, 400, 0, 0},
+  {0xFFFFFF00, 0x8C, 1, 0, 400, 0, 0},
+  {0x00000100, 0x8C, 1, 0, 400, 0, 0},   // millis() wrapped
+  {0x00000300, 0x8C, 1, 0, 400, 0, 0},
+};
+
+/* Every field from one end of its range to the other and back */
+static const sCodecSample_t valueSamples[] = {
+  {0, 0x00, 0, 0, 0, 0, 0},
+  {1, 0xFF, 255, 65535, 65535, 0, 0},
+  {2, 0x00, 0, 0, 0, 0, 0},
+  {3, 0x8F, 5, 65000, 400, 0, 0},
+  {4, 0x8F, 5, 64999, 401, 0, 0},
+};
+
+static const sCodecSample_t tempHumSamples[] = {
+  {0, 0x0C, 1, 0, 400, -32768, 0},
+  {1000, 0x0C, 1, 0, 400, 32767, 65535},
+  {2000, 0x0C, 1, 0, 400, -32768, 0},
+  {3000, 0x0C, 1, 0, 400, 2512, 4801},
+  {4000, 0x0C, 1, 0, 400, -1, 10000},
+};
+
+static const sCase_t cases[] = {
+  {0, sizeof(timeSamples) / sizeof(timeSamples[0]), timeSamples},
+  {0, sizeof(valueSamples) / sizeof(valueSamples[0]), valueSamples},
+  {ENS160_CODEC_TEMP_HUM, sizeof(tempHumSamples) / sizeof(tempHumSamples[0]), tempHumSamples},
+};
+
+static size_t encode(const sCase_t &c, uint8_t *block)
+{
+  DFRobot_ENS160_Encoder encoder;
+  CHECK(encoder.begin(block, BLOCK_SIZE, c.flags));
+  for(uint8_t i = 0; i < c.count; i++) {
+    CHECK(encoder.add(c.samples[i]));
+  }
+  CHECK_EQ(encoder.getCount(), c.count);
+  return encoder.getLength();
+}
+
+static void testRoundTrip(void)
+{
+  static uint8_t block[BLOCK_SIZE];
+  for(uint8_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) {
+    const sCase_t &c = cases[n];
+    size_t len = encode(c, block);
+    DFRobot_ENS160_Decoder decoder;
+    sCodecSample_t s;
+    CHECK(decoder.begin(block, len));
+    CHECK_EQ(decoder.getCount(), c.count);
+    CHECK_EQ(decoder.getFlags(), c.flags);
+    for(uint8_t i = 0; i < c.count; i++) {
+      CHECK(decoder.next(&s));
+      CHECK_EQ(s.timestamp, c.samples[i].timestamp);
+      CHECK_EQ(s.status, c.samples[i].status);
+      CHECK_EQ(s.AQI, c.samples[i].AQI);
+      CHECK_EQ(s.TVOC, c.samples[i].TVOC);
+      CHECK_EQ(s.ECO2, c.samples[i].ECO2);
+      if(c.flags & ENS160_CODEC_TEMP_HUM) {
+        CHECK_EQ(s.temp, c.samples[i].temp);
+        CHECK_EQ(s.hum, c.samples[i].hum);
+      }
+    }
+    CHECK(!decoder.next(&s));
+
+    CHECK(decoder.begin(block, len - 1));   // Truncated in the last record
+    for(uint8_t i = 0; i + 1 < c.count; i++) {
+      CHECK(decoder.next(&s));
+    }
+    CHECK(!decoder.next(&s));
+  }
+}
+
+static void testSize(void)
+{
+  static uint8_t block[BLOCK_SIZE];
+  DFRobot_ENS160_Encoder encoder;
+  sCodecSample_t s = {0, 0x8C, 1, 0, 400, 0, 0};
+  encoder.begin(block, BLOCK_SIZE, 0);
+  for(uint16_t i = 0; i < ENS160_CODEC_MAX_SAMPLES; i++) {
+    s.timestamp = 1000 * i;
+    CHECK(encoder.add(s));
+  }
+  CHECK(!encoder.add(s));   // Block full
+  // Header, the first two records set the values and the rate, then one byte per sample
+  CHECK(encoder.getLength() <= ENS160_CODEC_HEADER_SIZE + 8 + 2 + (ENS160_CODEC_MAX_SAMPLES - 2));
+
+  uint8_t small[ENS160_CODEC_HEADER_SIZE + 2];
+  encoder.begin(small, sizeof(small), 0);
+  CHECK(!encoder.add(s));   // Record does not fit
+  CHECK_EQ(encoder.getLength(), ENS160_CODEC_HEADER_SIZE);
+  CHECK(!encoder.begin(small, ENS160_CODEC_HEADER_SIZE - 1, 0));
+}
+
+static void dump(void)
+{
+  static uint8_t block[BLOCK_SIZE];
+  for(uint8_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) {
+    const sCase_t &c = cases[n];
+    size_t len = encode(c, block);
+    printf("{\"flags\": %u, \"block\": \"", c.flags);
+    for(size_t i = 0; i < len; i++) {
+      printf("%02x", block[i]);
+    }
+    printf("\", \"samples\": [");
+    for(uint8_t i = 0; i < c.count; i++) {
+      const sCodecSample_t &s = c.samples[i];
+      printf("%s[%lu, %u, %u, %u, %u, %d, %u]", i ? ", " : "", (unsigned long)s.timestamp, s.status, s.AQI,
+             s.TVOC, s.ECO2, s.temp, s.hum);
+    }
+    printf("]}\n");
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if((argc > 1) && (0 == strcmp(argv[1], "--dump"))) {
+    dump();
+    return 0;
+  }
+  RUN_TEST(testRoundTrip);
+  RUN_TEST(testSize);
+  return testResult();
+}
@@ -0,0 +1,187 @@
+/*!
+ * @file  test_events.cpp
+ * @brief  Unit tests of DFRobot_ENS160_Events
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_Events.h"
+
+static uint8_t callbackCount = 0;
+
+static void onEvent(const DFRobot_ENS160_Events::sEvent_t *event)
+{
+  (void)event;
+  callbackCount++;
+}
+
+static DFRobot_ENS160::sSnapshot_t sample(uint8_t AQI, uint16_t TVOC, uint16_t ECO2)
+{
+  DFRobot_ENS160::sSnapshot_t s;
+  memset(&s, 0, sizeof(s));
+  s.status.validityFlag = DFRobot_ENS160::eNormalOperation;
+  s.AQI = AQI;
+  s.TVOC = TVOC;
+  s.ECO2 = ECO2;
+  return s;
+}
+
+static void testLevels(void)
+{
+  DFRobot_ENS160_Events events;
+  DFRobot_ENS160_Events::sEvent_t event;
+  CHECK_EQ(events.addECO2Levels(50), 0);
+
+  CHECK(!events.update(sample(1, 0, 650), 0));   // The first sample sets the level, no event
+  CHECK_EQ(events.getLevel(0), 1);
+  CHECK(!events.readEvent(&event));
+
+  CHECK(events.update(sample(1, 0, 820), 1000));
+  CHECK(events.readEvent(&event));
+  CHECK_EQ(event.rule, 0);
+  CHECK_EQ(event.channel, DFRobot_ENS160_Events::eChannelECO2);
+  CHECK_EQ(event.from, 1);
+  CHECK_EQ(event.to, 2);
+  CHECK_EQ(event.value, 820);
+  CHECK_EQ(event.timestamp, 1000);
+
+  // Hysteresis: level 2 is only left below 800 - 50
+  CHECK(!events.update(sample(1, 0, 760), 2000));
+  CHECK(!events.update(sample(1, 0, 750), 3000));
+  CHECK_EQ(events.getLevel(0), 2);
+  CHECK(events.update(sample(1, 0, 740), 4000));
+  CHECK_EQ(events.getLevel(0), 1);
+
+  // Several thresholds crossed at once make one event
+  CHECK(events.update(sample(1, 0, 1600), 5000));
+  CHECK(events.readEvent(&event));
+  CHECK(events.readEvent(&event));
+  CHECK_EQ(event.from, 1);
+  CHECK_EQ(event.to, 4);
+  CHECK(!events.readEvent(&event));
+}
+
+static void testConfirm(void)
+{
+  DFRobot_ENS160_Events events;
+  DFRobot_ENS160_Events::sEvent_t event;
+  events.addAQIBand(3);
+
+  events.update(sample(1, 0, 400), 0);
+  CHECK(!events.update(sample(3, 0, 400), 1000));
+  CHECK(!events.update(sample(3, 0, 400), 2000));
+  CHECK(!events.update(sample(1, 0, 400), 3000));   // Back before confirmed: starts over
+  CHECK(!events.update(sample(3, 0, 400), 4000));
+  CHECK(!events.update(sample(4, 0, 400), 5000));   // Another level: starts over
+  CHECK(!events.update(sample(4, 0, 400), 6000));
+  CHECK(events.update(sample(4, 0, 400), 7000));
+  CHECK(events.readEvent(&event));
+  CHECK_EQ(event.from, 0);
+  CHECK_EQ(event.to, 3);
+  CHECK_EQ(event.timestamp, 7000);
+}
+
+static void testRate(void)
+{
+  DFRobot_ENS160_Events events;
+  DFRobot_ENS160_Events::sEvent_t event;
+  CHECK_EQ(events.addRateLimit(DFRobot_ENS160_Events::eChannelTVOC, 100, 100, 10000), -1);   // No room to release
+  CHECK_EQ(events.addRateLimit(DFRobot_ENS160_Events::eChannelTVOC, 100, 20, 10000), 0);
+
+  // One check per window: 10 s windows, so a change of 10 ppb is 60 ppb/min
+  events.update(sample(1, 1000, 400), 0);
+  CHECK(!events.update(sample(1, 1500, 400), 5000));   // Inside the window, not checked
+  CHECK(events.update(sample(1, 1020, 400), 10000));   // 120/min
+  CHECK(events.readEvent(&event));
+  CHECK_EQ(event.from, DFRobot_ENS160_Events::eRateSteady);
+  CHECK_EQ(event.to, DFRobot_ENS160_Events::eRateRising);
+  CHECK_EQ(event.value, 120);
+
+  // The windows do not overlap: the next one starts at 10 s with 1020
+  CHECK(!events.update(sample(1, 1035, 400), 20000));   // 90/min, above the release of 80
+  CHECK_EQ(events.getLevel(0), DFRobot_ENS160_Events::eRateRising);
+  CHECK(events.update(sample(1, 1045, 400), 30000));   // 60/min
+  CHECK(events.readEvent(&event));
+  CHECK_EQ(event.to, DFRobot_ENS160_Events::eRateSteady);
+  CHECK(events.update(sample(1, 1010, 400), 45000));   // -140/min over the 15 s since the last check
+  CHECK(events.readEvent(&event));
+  CHECK_EQ(event.to, DFRobot_ENS160_Events::eRateFalling);
+  CHECK_EQ(event.value, -140);
+}
+
+static void testQueue(void)
+{
+  DFRobot_ENS160_Events events;
+  DFRobot_ENS160_Events::sEvent_t event;
+  events.addECO2Levels(0);
+  events.setEventCallback(onEvent);
+  callbackCount = 0;
+
+  events.update(sample(1, 0, 400), 0);
+  CHECK(!events.checkWake());
+  for(uint32_t i = 1; i <= ENS160_EVENT_QUEUE + 2; i++) {
+    CHECK(events.update(sample(1, 0, (i & 1) ? 700 : 400), i));
+  }
+  CHECK_EQ(callbackCount, ENS160_EVENT_QUEUE + 2);
+  CHECK_EQ(events.getDroppedCount(), 2);
+  CHECK(events.checkWake());
+  CHECK(!events.checkWake());
+
+  // The oldest were dropped
+  for(uint32_t i = 3; i <= ENS160_EVENT_QUEUE + 2; i++) {
+    CHECK(events.readEvent(&event));
+    CHECK_EQ(event.timestamp, i);
+  }
+  CHECK(!events.readEvent(&event));
+}
+
+static void testValidity(void)
+{
+  DFRobot_ENS160_Events events;
+  events.addECO2Levels();
+  DFRobot_ENS160::sSnapshot_t warmUp = sample(1, 0, 1200);
+  warmUp.status.validityFlag = DFRobot_ENS160::eWarmUpPhase;
+
+  events.update(sample(1, 0, 400), 0);
+  CHECK(!events.update(warmUp, 1000));
+  CHECK_EQ(events.getLevel(0), 0);
+  events.setValidOnly(false);
+  CHECK(events.update(warmUp, 2000));
+  CHECK_EQ(events.getLevel(0), 3);
+}
+
+static void testAttach(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Events events;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  events.addECO2Levels();
+  events.attach(&sim);
+  sim.begin();
+  advance(ENS160_SIM_WARM_UP_TIME);
+
+  sim.setEnvironment(1, 0, 500);
+  advance(ENS160_SIM_PERIOD);
+  sim.readSnapshot(&snapshot);
+  sim.setEnvironment(1, 0, 900);
+  advance(ENS160_SIM_PERIOD);
+  sim.readSnapshot(&snapshot);
+  CHECK(events.checkWake());
+  CHECK_EQ(events.getLevel(0), 2);
+}
+
+int main(void)
+{
+  RUN_TEST(testLevels);
+  RUN_TEST(testConfirm);
+  RUN_TEST(testRate);
+  RUN_TEST(testQueue);
+  RUN_TEST(testValidity);
+  RUN_TEST(testAttach);
+  return testResult();
+}
@@ -0,0 +1,180 @@
+/*!
+ * @file  test_heal.cpp
+ * @brief  Unit tests of the self-healing against the simulated ENS160
+ * @details  Brown-out (the sensor loses its registers) and bus faults (it keeps them), and the backoff
+ * @n        of failed recovery attempts.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "ens160_test_sim.h"
+
+#define TEST_CONFIG   (DFRobot_ENS160::eINTModeEN | DFRobot_ENS160::eINTPinPP | DFRobot_ENS160::eINTDataDrdyEN)
+
+/* A healthy sensor past its warm-up, with compensation and the counters cleared */
+static void setUp(TestSim &sim)
+{
+  sim.begin();
+  sim.setINTMode(TEST_CONFIG);
+  sim.setTempAndHum(30.0, 40.0);
+  sim.setSelfHealing(true);
+  advance(ENS160_SIM_WARM_UP_TIME);
+  sim.modeWrites = 0;
+  sim.configWrites = 0;
+  sim.compWrites = 0;
+}
+
+static void testBrownOut(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  DFRobot_ENS160::sHealthStats_t stats;
+  setUp(sim);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+  uint8_t tempIn = sim.peekReg(ENS160_TEMP_IN_REG);
+
+  sim.powerCycle();   // Back in DEEP SLEEP with the default registers
+  CHECK_EQ(sim.readSnapshot(&snapshot), ERR_SENSOR_FAULT);   // STANDARD mode stopped running
+  CHECK_EQ(snapshot.stale, 1);
+  CHECK(!sim.isRecovering());   // Recovered at once
+  while(!sim.isReady()) {
+    sim.poll();
+    yield();
+  }
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_CONFIG_REG), TEST_CONFIG);
+  CHECK_EQ(sim.peekReg(ENS160_TEMP_IN_REG), tempIn);
+  CHECK_EQ(sim.modeWrites, 1);
+  CHECK_EQ(sim.configWrites, 1);
+  CHECK_EQ(sim.compWrites, 1);
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eWarmUpPhase);   // The chip starts over
+  CHECK(sim.getHeaterOnTime() < 1000);
+
+  advance(ENS160_SIM_PERIOD);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+  sim.getHealthStats(&stats);
+  CHECK_EQ(stats.faults, 1);
+  CHECK_EQ(stats.attempts, 1);
+  CHECK_EQ(stats.recoveries, 1);
+  CHECK_EQ(stats.staleSamples, 1);
+}
+
+static void testBusFaultKeepsWarmUp(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  DFRobot_ENS160::sHealthStats_t stats;
+  setUp(sim);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+  uint32_t heaterOnTime = sim.getHeaterOnTime();
+
+  sim.injectReadErrors(ENS160_HEAL_ERRORS);
+  for(uint8_t i = 1; i < ENS160_HEAL_ERRORS; i++) {
+    CHECK_EQ(sim.readSnapshot(&snapshot), ERR_DATA_BUS);
+  }
+  CHECK_EQ(sim.readSnapshot(&snapshot), ERR_SENSOR_FAULT);
+  CHECK(!sim.isRecovering());
+  sim.getHealthStats(&stats);
+  CHECK_EQ(stats.recoveries, 1);
+
+  // The sensor kept its configuration: nothing is written, the warm-up is not restarted
+  CHECK_EQ(sim.modeWrites, 0);
+  CHECK_EQ(sim.configWrites, 0);
+  CHECK_EQ(sim.compWrites, 0);
+  CHECK(sim.isReady());
+  CHECK(sim.getHeaterOnTime() >= heaterOnTime);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+  CHECK_EQ(snapshot.status.validityFlag, DFRobot_ENS160::eNormalOperation);
+}
+
+static void testBackoff(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  DFRobot_ENS160::sHealthStats_t stats;
+  DFRobot_ENS160_Sim::sSimStats_t before, after;
+  setUp(sim);
+
+  sim.injectReadErrors(0xFF);   // The bus is gone
+  for(uint8_t i = 0; i < ENS160_HEAL_ERRORS; i++) {
+    sim.readSnapshot(&snapshot);
+  }
+  CHECK(sim.isRecovering());
+  sim.getHealthStats(&stats);
+  CHECK_EQ(stats.attempts, 1);   // The first attempt is made at once
+
+  // Attempts after 100, 200, 400 ... ms, the reads in between do not touch the bus
+  uint32_t backoff = ENS160_HEAL_BACKOFF_MIN;
+  for(uint8_t n = 2; n <= 6; n++) {
+    advance(backoff - 1);
+    sim.getSimStats(&before);
+    CHECK_EQ(sim.readSnapshot(&snapshot), ERR_SENSOR_FAULT);
+    sim.getSimStats(&after);
+    CHECK_EQ(after.readTransactions, before.readTransactions);
+    sim.getHealthStats(&stats);
+    CHECK_EQ(stats.attempts, n - 1);
+    advance(1);
+    CHECK_EQ(sim.readSnapshot(&snapshot), ERR_SENSOR_FAULT);
+    sim.getHealthStats(&stats);
+    CHECK_EQ(stats.attempts, n);
+    backoff *= 2;
+  }
+
+  // Capped at ENS160_HEAL_BACKOFF_MAX
+  for(uint8_t i = 0; i < 4; i++) {
+    advance(ENS160_HEAL_BACKOFF_MAX);
+    sim.readSnapshot(&snapshot);
+  }
+  sim.getHealthStats(&stats);
+  uint32_t attempts = stats.attempts;
+  advance(ENS160_HEAL_BACKOFF_MAX);
+  sim.readSnapshot(&snapshot);
+  sim.getHealthStats(&stats);
+  CHECK_EQ(stats.attempts, attempts + 1);
+
+  // The bus is back: the next due attempt recovers, the sample after it is good
+  sim.injectReadErrors(0);
+  advance(ENS160_HEAL_BACKOFF_MAX);
+  sim.readSnapshot(&snapshot);
+  CHECK(!sim.isRecovering());
+  sim.getHealthStats(&stats);
+  CHECK_EQ(stats.faults, 1);
+  CHECK_EQ(stats.recoveries, 1);
+  CHECK_EQ(sim.modeWrites, 0);
+  advance(ENS160_SIM_PERIOD);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+}
+
+static void testConfigLost(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  setUp(sim);
+
+  sim.writeByte(ENS160_CONFIG_REG, 0);   // Only CONFIG changed behind the driver's back
+  sim.configWrites = 0;
+  advance(ENS160_HEAL_CHECK_TIME);
+  CHECK_EQ(sim.readSnapshot(&snapshot), ERR_SENSOR_FAULT);
+  while(!sim.isReady()) {
+    sim.poll();
+    yield();
+  }
+  CHECK_EQ(sim.peekReg(ENS160_CONFIG_REG), TEST_CONFIG);
+  CHECK_EQ(sim.configWrites, 1);
+  CHECK_EQ(sim.modeWrites, 0);   // OPMODE was right, the warm-up goes on
+  CHECK_EQ(sim.compWrites, 0);
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eNormalOperation);
+}
+
+int main(void)
+{
+  RUN_TEST(testBrownOut);
+  RUN_TEST(testBusFaultKeepsWarmUp);
+  RUN_TEST(testBackoff);
+  RUN_TEST(testConfigLost);
+  return testResult();
+}
@@ -0,0 +1,280 @@
+/*!
+ * @file  test_linux.cpp
+ * @brief  Unit tests of the i2c-dev and spidev backends with a fake ioctl() installed by setIoctl()
+ * @details  The fake checks the message layout the kernel gets (combined I2C_RDWR write+read, the
+ * @n        SPI_IOC_MESSAGE buffers) and emulates the register file behind it. /dev/null stands in
+ * @n        for the device node.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Linux.h"
+#include <string.h>
+
+#define FAKE_DEVICE   "/dev/null"
+#define FAKE_REG_NUM  0x50
+
+/* What the fake saw and the register file it emulates */
+static uint8_t fakeRegs[FAKE_REG_NUM];
+static uint32_t fakeCalls;   // Data transfers
+static uint32_t fakeFailures;   // Transfers to fail before the next succeeds
+static unsigned long fakeRequest;   // Last request
+static uint32_t fakeMsgCount;   // I2C: messages of the last transfer
+static struct i2c_msg fakeMsgs[2];
+static uint8_t fakeTx[1 + ENS160_LINUX_MAX_XFER];   // Copy of the last write message / SPI tx buffer
+static struct spi_ioc_transfer fakeXfer;
+static uint8_t fakeSPIMode, fakeSPIBits;
+static uint32_t fakeSPISpeed;
+
+static void fakeReset(void)
+{
+  memset(fakeRegs, 0, sizeof(fakeRegs));
+  fakeRegs[ENS160_PART_ID_REG] = ENS160_PART_ID & 0xFF;
+  fakeRegs[ENS160_PART_ID_REG + 1] = ENS160_PART_ID >> 8;
+  fakeCalls = 0;
+  fakeFailures = 0;
+  fakeRequest = 0;
+  fakeMsgCount = 0;
+}
+
+static int fakeI2CIoctl(int fd, unsigned long request, void *arg)
+{
+  (void)fd;
+  fakeRequest = request;
+  if(I2C_RDWR != request) {
+    return -1;
+  }
+  fakeCalls++;
+  if(fakeFailures) {
+    fakeFailures--;
+    return -1;
+  }
+  struct i2c_rdwr_ioctl_data *data = (struct i2c_rdwr_ioctl_data *)arg;
+  fakeMsgCount = data->nmsgs;
+  if((data->nmsgs < 1) || (data->nmsgs > 2) || (data->msgs[0].flags & I2C_M_RD)) {
+    return -1;
+  }
+  memcpy(fakeMsgs, data->msgs, data->nmsgs * sizeof(struct i2c_msg));
+  memcpy(fakeTx, data->msgs[0].buf, data->msgs[0].len);
+  uint8_t reg = data->msgs[0].buf[0];
+  if(1 == data->nmsgs) {   // Write: register address and data
+    for(uint16_t i = 1; i < data->msgs[0].len; i++) {
+      fakeRegs[(reg + i - 1) % FAKE_REG_NUM] = data->msgs[0].buf[i];
+    }
+  } else {   // Combined write of the register address and read, with a repeated start
+    for(uint16_t i = 0; i < data->msgs[1].len; i++) {
+      data->msgs[1].buf[i] = fakeRegs[(reg + i) % FAKE_REG_NUM];
+    }
+  }
+  return (int)data->nmsgs;
+}
+
+static int fakeSPIIoctl(int fd, unsigned long request, void *arg)
+{
+  (void)fd;
+  fakeRequest = request;
+  if(SPI_IOC_WR_MODE == request) {
+    fakeSPIMode = *(uint8_t *)arg;
+    return 0;
+  } else if(SPI_IOC_WR_BITS_PER_WORD == request) {
+    fakeSPIBits = *(uint8_t *)arg;
+    return 0;
+  } else if(SPI_IOC_WR_MAX_SPEED_HZ == request) {
+    fakeSPISpeed = *(uint32_t *)arg;
+    return 0;
+  } else if(SPI_IOC_MESSAGE(1) != request) {
+    return -1;
+  }
+  fakeCalls++;
+  if(fakeFailures) {
+    fakeFailures--;
+    return -1;
+  }
+  struct spi_ioc_transfer *xfer = (struct spi_ioc_transfer *)arg;
+  const uint8_t *tx = (const uint8_t *)(uintptr_t)xfer->tx_buf;
+  uint8_t *rx = (uint8_t *)(uintptr_t)xfer->rx_buf;
+  fakeXfer = *xfer;
+  memcpy(fakeTx, tx, xfer->len);
+  uint8_t reg = tx[0] >> 1;
+  rx[0] = 0;
+  for(uint32_t i = 1; i < xfer->len; i++) {
+    if(tx[0] & 0x01) {   // Read: the data follows the address byte, full duplex
+      rx[i] = fakeRegs[(reg + i - 1) % FAKE_REG_NUM];
+    } else {
+      fakeRegs[(reg + i - 1) % FAKE_REG_NUM] = tx[i];
+      rx[i] = 0;
+    }
+  }
+  return (int)xfer->len;
+}
+
+/* The backends with the raw register access opened up */
+class TestI2C:public DFRobot_ENS160_LinuxI2C
+{
+public:
+  using DFRobot_ENS160_LinuxI2C::DFRobot_ENS160_LinuxI2C;
+  using DFRobot_ENS160_LinuxI2C::readReg;
+  using DFRobot_ENS160_LinuxI2C::writeReg;
+};
+
+class TestSPI:public DFRobot_ENS160_LinuxSPI
+{
+public:
+  using DFRobot_ENS160_LinuxSPI::DFRobot_ENS160_LinuxSPI;
+  using DFRobot_ENS160_LinuxSPI::readReg;
+  using DFRobot_ENS160_LinuxSPI::writeReg;
+};
+
+static void testI2CMessages(void)
+{
+  TestI2C sensor(FAKE_DEVICE, 0x52);
+  uint8_t buf[40];
+  fakeReset();
+  sensor.setIoctl(fakeI2CIoctl);
+  CHECK_EQ(sensor.begin(), NO_ERR);
+  CHECK_EQ(fakeRegs[ENS160_OPMODE_REG], ENS160_STANDARD_MODE);
+  CHECK_EQ(fakeRequest, I2C_RDWR);
+
+  // Read: one combined transfer, write of the register address then read with a repeated start
+  fakeRegs[ENS160_DATA_TVOC_REG] = 0x34;
+  fakeRegs[ENS160_DATA_TVOC_REG + 1] = 0x12;
+  fakeCalls = 0;
+  CHECK_EQ(sensor.getTVOC(), 0x1234);
+  CHECK_EQ(fakeCalls, 1);
+  CHECK_EQ(fakeMsgCount, 2);
+  CHECK_EQ(fakeMsgs[0].addr, 0x52);
+  CHECK_EQ(fakeMsgs[0].flags, 0);
+  CHECK_EQ(fakeMsgs[0].len, 1);
+  CHECK_EQ(fakeTx[0], ENS160_DATA_TVOC_REG);
+  CHECK_EQ(fakeMsgs[1].addr, 0x52);
+  CHECK_EQ(fakeMsgs[1].flags, I2C_M_RD);
+  CHECK_EQ(fakeMsgs[1].len, 2);
+
+  // Write: one message, register address followed by the data
+  fakeCalls = 0;
+  sensor.setTempAndHum(25.0, 50.0);
+  CHECK_EQ(fakeCalls, 1);
+  CHECK_EQ(fakeMsgCount, 1);
+  CHECK_EQ(fakeMsgs[0].addr, 0x52);
+  CHECK_EQ(fakeMsgs[0].flags, 0);
+  CHECK_EQ(fakeMsgs[0].len, 5);
+  CHECK_EQ(fakeTx[0], ENS160_TEMP_IN_REG);
+  uint16_t temp = (25.0 + 273.15) * 64;
+  CHECK_EQ(fakeRegs[ENS160_TEMP_IN_REG], temp & 0xFF);
+  CHECK_EQ(fakeRegs[ENS160_TEMP_IN_REG + 1], temp >> 8);
+  CHECK_EQ(fakeRegs[ENS160_RH_IN_REG + 1], (50 * 512) >> 8);
+
+  // Blocks longer than ENS160_LINUX_MAX_XFER are split, the register address follows
+  for(uint8_t i = 0; i < sizeof(buf); i++) {
+    fakeRegs[i] = i;
+  }
+  fakeCalls = 0;
+  memset(buf, 0xFF, sizeof(buf));
+  CHECK_EQ(sensor.readReg(0, buf, sizeof(buf)), sizeof(buf));
+  CHECK_EQ(fakeCalls, 2);
+  CHECK_EQ(fakeTx[0], ENS160_LINUX_MAX_XFER);
+  CHECK_EQ(fakeMsgs[1].len, sizeof(buf) - ENS160_LINUX_MAX_XFER);
+  CHECK_EQ(buf[0], 0);
+  CHECK_EQ(buf[sizeof(buf) - 1], sizeof(buf) - 1);
+}
+
+static void testI2CRetries(void)
+{
+  TestI2C sensor(FAKE_DEVICE);
+  uint8_t buf[2];
+  fakeReset();
+  sensor.setIoctl(fakeI2CIoctl);
+  CHECK_EQ(sensor.begin(), NO_ERR);
+
+  fakeCalls = 0;
+  fakeFailures = ENS160_LINUX_RETRIES;   // Recovered by the retries
+  CHECK_EQ(sensor.readReg(ENS160_PART_ID_REG, buf, sizeof(buf)), 2);
+  CHECK_EQ(fakeCalls, 1 + ENS160_LINUX_RETRIES);
+
+  fakeCalls = 0;
+  fakeFailures = 1;
+  sensor.setRetries(0);
+  CHECK_EQ(sensor.readReg(ENS160_PART_ID_REG, buf, sizeof(buf)), 0);
+  CHECK_EQ(fakeCalls, 1);
+
+  TestI2C missing("/nonexistent/i2c-9");
+  missing.setIoctl(fakeI2CIoctl);
+  CHECK_EQ(missing.begin(), ERR_DATA_BUS);
+}
+
+static void testSPIBuffers(void)
+{
+  TestSPI sensor(FAKE_DEVICE, 20000000);
+  fakeReset();
+  sensor.setIoctl(fakeSPIIoctl);
+  CHECK_EQ(sensor.begin(), NO_ERR);
+  CHECK_EQ(fakeSPIMode, SPI_MODE_0);
+  CHECK_EQ(fakeSPIBits, 8);
+  CHECK_EQ(fakeSPISpeed, ENS160_SPI_MAX_CLOCK);   // Limited to what the chip supports
+  CHECK_EQ(fakeRegs[ENS160_OPMODE_REG], ENS160_STANDARD_MODE);
+
+  // Read: address byte (reg << 1 | 1) then dummy bytes, the data comes back after the address byte
+  fakeRegs[ENS160_DATA_ECO2_REG] = 0x90;
+  fakeRegs[ENS160_DATA_ECO2_REG + 1] = 0x01;
+  fakeCalls = 0;
+  CHECK_EQ(sensor.getECO2(), 0x0190);
+  CHECK_EQ(fakeCalls, 1);
+  CHECK_EQ(fakeRequest, SPI_IOC_MESSAGE(1));
+  CHECK_EQ(fakeXfer.len, 3);
+  CHECK_EQ(fakeTx[0], (ENS160_DATA_ECO2_REG << 1) | 0x01);
+  CHECK_EQ(fakeTx[1], 0);
+  CHECK(0 != fakeXfer.rx_buf);
+  CHECK(fakeXfer.tx_buf != fakeXfer.rx_buf);
+  CHECK_EQ(fakeXfer.speed_hz, ENS160_SPI_MAX_CLOCK);
+  CHECK_EQ(fakeXfer.bits_per_word, 8);
+
+  // Write: address byte (reg << 1) then the data, one transfer
+  fakeCalls = 0;
+  sensor.setPWRMode(ENS160_IDLE_MODE);
+  CHECK_EQ(fakeCalls, 1);
+  CHECK_EQ(fakeXfer.len, 2);
+  CHECK_EQ(fakeTx[0], ENS160_OPMODE_REG << 1);
+  CHECK_EQ(fakeTx[1], ENS160_IDLE_MODE);
+  CHECK_EQ(fakeRegs[ENS160_OPMODE_REG], ENS160_IDLE_MODE);
+
+  // The clock takes effect with the next transfer
+  sensor.setClock(1000000);
+  sensor.getAQI();
+  CHECK_EQ(fakeXfer.speed_hz, 1000000);
+
+  fakeFailures = 1;
+  CHECK_EQ(sensor.getTVOC(), 0);
+}
+
+static void testNullBuffer(void)
+{
+  TestI2C i2c(FAKE_DEVICE);
+  TestSPI spi(FAKE_DEVICE);
+  fakeReset();
+  i2c.setIoctl(fakeI2CIoctl);
+  spi.setIoctl(fakeSPIIoctl);
+  CHECK_EQ(i2c.begin(), NO_ERR);
+  CHECK_EQ(spi.begin(), NO_ERR);
+
+  // Nothing goes on the bus
+  fakeCalls = 0;
+  CHECK_EQ(i2c.readReg(ENS160_PART_ID_REG, NULL, 2), 0);
+  i2c.writeReg(ENS160_OPMODE_REG, NULL, 1);
+  CHECK_EQ(spi.readReg(ENS160_PART_ID_REG, NULL, 2), 0);
+  spi.writeReg(ENS160_OPMODE_REG, NULL, 1);
+  CHECK_EQ(fakeCalls, 0);
+  CHECK_EQ(fakeRegs[ENS160_OPMODE_REG], ENS160_STANDARD_MODE);
+}
+
+int main(void)
+{
+  RUN_TEST(testI2CMessages);
+  RUN_TEST(testI2CRetries);
+  RUN_TEST(testSPIBuffers);
+  RUN_TEST(testNullBuffer);
+  return testResult();
+}
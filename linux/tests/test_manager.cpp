@@ -0,0 +1,166 @@
+/*!
+ * @file  test_manager.cpp
+ * @brief  Unit tests of DFRobot_ENS160_Manager against simulated sensors
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_Manager.h"
+
+static void testSweep(void)
+{
+  DFRobot_ENS160_Sim sim[3];
+  DFRobot_ENS160_Manager manager;
+  DFRobot_ENS160::sSnapshot_t samples[3];
+  for(uint8_t i = 0; i < 3; i++) {
+    sim[i].setEnvironment(1 + i, 100 * i, 400 + i);
+    CHECK_EQ(manager.addSensor(&sim[i]), i);
+  }
+  CHECK_EQ(manager.begin(), 3);
+  advance(ENS160_SIM_PERIOD);
+  CHECK_EQ(manager.sweep(samples), 3);
+  for(uint8_t i = 0; i < 3; i++) {
+    CHECK_EQ(samples[i].AQI, 1 + i);
+    CHECK_EQ(samples[i].ECO2, 400 + i);
+  }
+}
+
+static void testOfflineSensorIsInitialized(void)
+{
+  DFRobot_ENS160_Sim sim[2];
+  DFRobot_ENS160_Manager manager;
+  DFRobot_ENS160_Manager::sSensorHealth_t health;
+  DFRobot_ENS160::sSnapshot_t samples[2];
+  manager.addSensor(&sim[0]);
+  manager.addSensor(&sim[1]);
+
+  sim[1].injectReadErrors(1);   // PART_ID read of begin() fails
+  CHECK_EQ(manager.begin(), 1);
+  manager.getHealth(1, &health);
+  CHECK(!health.online);
+  CHECK_EQ(sim[1].peekReg(ENS160_OPMODE_REG), ENS160_SLEEP_MODE);
+
+  // The retry initializes the sensor before it counts as online
+  uint8_t sweeps = 0;
+  do {
+    manager.sweep(samples);
+    advance(ENS160_SWITCH_TIME);
+    manager.getHealth(1, &health);
+  } while(!health.online && (++sweeps <= ENS160_MANAGER_RETRY_SWEEPS + 3));
+  CHECK(health.online);
+  CHECK_EQ(health.lastResult, NO_ERR);
+  CHECK_EQ(sim[1].peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+  CHECK(sim[1].peekReg(ENS160_CONFIG_REG) & DFRobot_ENS160::eINTDataDrdyEN);
+
+  // A sensor that fails its reads is initialized again too, e.g. after a power cycle
+  for(uint8_t i = 0; i < ENS160_MANAGER_OFFLINE_COUNT; i++) {
+    sim[1].injectReadErrors(1);
+    manager.sweep(samples);
+  }
+  manager.getHealth(1, &health);
+  CHECK(!health.online);
+  sim[1].powerCycle();
+  sweeps = 0;
+  do {
+    manager.sweep(samples);
+    advance(ENS160_SWITCH_TIME);
+    manager.getHealth(1, &health);
+  } while(!health.online && (++sweeps <= ENS160_MANAGER_RETRY_SWEEPS + 3));
+  CHECK(health.online);
+  CHECK_EQ(sim[1].peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+}
+
+static void testTransientErrorRecovers(void)
+{
+  DFRobot_ENS160_Sim sim[2];
+  DFRobot_ENS160_Manager manager;
+  DFRobot_ENS160_Manager::sSensorHealth_t health;
+  DFRobot_ENS160::sSnapshot_t samples[2];
+  manager.addSensor(&sim[0]);
+  manager.addSensor(&sim[1]);
+  manager.begin();
+  advance(ENS160_SIM_PERIOD);
+
+  sim[1].injectReadErrors(1);
+  CHECK_EQ(manager.sweep(samples), 1);
+  manager.getHealth(1, &health);
+  CHECK_EQ(health.consecutiveErrors, 1);
+  CHECK(health.online);
+
+  // The next cycle reads the sensor again, no re-init needed
+  DFRobot_ENS160_Sim::sSimStats_t stats;
+  sim[1].resetSimStats();
+  CHECK_EQ(manager.sweep(samples), 2);
+  manager.getHealth(1, &health);
+  CHECK(health.online);
+  CHECK_EQ(health.consecutiveErrors, 0);
+  CHECK_EQ(health.lastResult, NO_ERR);
+  CHECK_EQ(health.reads, 2);
+  CHECK_EQ(health.errors, 1);
+  sim[1].getSimStats(&stats);
+  CHECK_EQ(stats.writeTransactions, 0);
+}
+
+static void testReinitDoesNotBlock(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Manager manager;
+  DFRobot_ENS160_Manager::sSensorHealth_t health;
+  DFRobot_ENS160::sSnapshot_t samples[1];
+  manager.addSensor(&sim);
+  sim.injectReadErrors(1);
+  CHECK_EQ(manager.begin(), 0);
+
+  uint64_t start = ens160FakeMicros;
+  CHECK_EQ(manager.sweep(samples), 0);   // Sweep 0 retries: beginAsync() only
+  CHECK(ens160FakeMicros - start < 1000);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+  manager.getHealth(0, &health);
+  CHECK(!health.online);
+
+  start = ens160FakeMicros;
+  CHECK_EQ(manager.sweep(samples), 0);   // Still switching, the next sweeps poll it
+  CHECK(ens160FakeMicros - start < 1000);
+  for(uint8_t i = 0; (i < 4) && !health.online; i++) {
+    advance(ENS160_SWITCH_TIME);
+    manager.sweep(samples);
+    manager.getHealth(0, &health);
+  }
+  CHECK(health.online);
+  CHECK(sim.peekReg(ENS160_CONFIG_REG) & DFRobot_ENS160::eINTDataDrdyEN);
+}
+
+static void testReinitFailureStaysOffline(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Manager manager;
+  DFRobot_ENS160_Manager::sSensorHealth_t health;
+  DFRobot_ENS160::sSnapshot_t samples[1];
+  manager.addSensor(&sim);
+  sim.injectReadErrors(1);
+  manager.begin();
+
+  sim.injectReadErrors(ENS160_MANAGER_RETRY_SWEEPS + 1);   // Every retry fails
+  for(uint8_t i = 0; i <= ENS160_MANAGER_RETRY_SWEEPS; i++) {
+    manager.sweep(samples);
+  }
+  manager.getHealth(0, &health);
+  CHECK(!health.online);
+  CHECK_EQ(health.lastResult, ERR_DATA_BUS);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_SLEEP_MODE);
+}
+
+int main(void)
+{
+  RUN_TEST(testSweep);
+  RUN_TEST(testOfflineSensorIsInitialized);
+  RUN_TEST(testTransientErrorRecovers);
+  RUN_TEST(testReinitDoesNotBlock);
+  RUN_TEST(testReinitFailureStaysOffline);
+  return testResult();
+}
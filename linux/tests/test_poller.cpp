@@ -0,0 +1,115 @@
+/*!
+ * @file  test_poller.cpp
+ * @brief  Unit tests of DFRobot_ENS160_Poller against the simulated ENS160
+ * @details  One virtual hour per case, with the nominal conversion period and with the chip
+ * @n        oscillator 3% slow and fast: reads per sample, the delay between data ready and its read,
+ * @n        and that the phase stays locked while the period is learned.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_Poller.h"
+
+#define RUN_TIME      3600000   ///< Virtual time per case, unit: ms
+#define SETTLE_TIME   60000   ///< Time given to lock and learn the period before measuring, unit: ms
+
+typedef struct
+{
+  uint32_t samples;
+  uint32_t transactions;
+  uint32_t maxLatency;   // unit: us
+  uint32_t missed;   // Conversions that were never read
+} sPollerRun_t;
+
+/* Run the poller like a loop() that sleeps getWaitTime() between the polls */
+static void runPoller(uint32_t simPeriod, sPollerRun_t *run, DFRobot_ENS160_Poller::sPollStats_t *stats)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Poller poller(&sim);
+  DFRobot_ENS160::sTimedSnapshot_t sample;
+
+  sim.setPeriod(simPeriod);
+  sim.begin();
+  poller.begin();
+  memset(run, 0, sizeof(sPollerRun_t));
+
+  uint32_t start = millis();
+  uint32_t lastConversion = 0;
+  DFRobot_ENS160_Poller::sPollStats_t settled = {0, 0, 0, 0, 0, 0};
+  bool measuring = false;
+  while((uint32_t)(millis() - start) < RUN_TIME) {
+    if(!measuring && ((uint32_t)(millis() - start) >= SETTLE_TIME)) {
+      measuring = true;
+      poller.getPollStats(&settled);
+    }
+    if(poller.poll(&sample)) {
+      uint32_t conversion = sim.getConversionTime();
+      if(measuring) {
+        uint32_t latency = micros() - conversion * 1000;
+        if(latency > run->maxLatency) {
+          run->maxLatency = latency;
+        }
+        if((conversion - lastConversion) > simPeriod) {
+          run->missed++;
+        }
+        run->samples++;
+      }
+      lastConversion = conversion;
+    }
+    uint32_t wait = poller.getWaitTime();
+    ens160FakeMicros += wait ? wait : ENS160_FAKE_YIELD_TIME;
+  }
+  poller.getPollStats(NULL);   // Ignored
+  poller.getPollStats(stats);
+  run->transactions = stats->transactions - settled.transactions;
+  printf("  period %lu ms: %lu samples, %lu.%02lu reads per sample, max latency %lu us, learned period %lu us\n",
+         (unsigned long)simPeriod, (unsigned long)run->samples,
+         (unsigned long)(run->transactions / run->samples),
+         (unsigned long)(run->transactions * 100 / run->samples % 100),
+         (unsigned long)run->maxLatency, (unsigned long)stats->period);
+}
+
+static void checkRun(uint32_t simPeriod)
+{
+  sPollerRun_t run;
+  DFRobot_ENS160_Poller::sPollStats_t stats;
+  runPoller(simPeriod, &run, &stats);
+
+  CHECK_EQ(run.missed, 0);   // Every conversion read once
+  CHECK(run.samples >= (RUN_TIME - SETTLE_TIME) / simPeriod);
+  CHECK(run.transactions * 100 <= run.samples * 140);   // At most 1.4 reads per sample
+  CHECK(stats.latency <= ENS160_POLL_RETRY + 100);   // Data ready bracketed within 1 ms
+  CHECK(run.maxLatency <= ENS160_POLL_GUARD + ENS160_POLL_RETRY);   // Read at most 2 ms after data ready
+  CHECK_EQ(stats.relocks, 0);   // Tracked without losing the phase, also while learning the period
+  CHECK_EQ(stats.errors, 0);
+  int32_t periodError = (int32_t)stats.period - (int32_t)(simPeriod * 1000);
+  CHECK(abs(periodError) < 1000);
+}
+
+static void testNominalPeriod(void)
+{
+  checkRun(ENS160_SIM_PERIOD);
+}
+
+static void testSlowOscillator(void)
+{
+  checkRun(ENS160_SIM_PERIOD * 103 / 100);
+}
+
+static void testFastOscillator(void)
+{
+  checkRun(ENS160_SIM_PERIOD * 97 / 100);
+}
+
+int main(void)
+{
+  RUN_TEST(testNominalPeriod);
+  RUN_TEST(testSlowOscillator);
+  RUN_TEST(testFastOscillator);
+  return testResult();
+}
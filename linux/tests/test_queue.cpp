@@ -0,0 +1,105 @@
+/*!
+ * @file  test_queue.cpp
+ * @brief  Unit tests of DFRobot_ENS160_SampleQueue
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_SampleQueue.h"
+
+static DFRobot_ENS160::sTimedSnapshot_t sample(uint32_t timestamp)
+{
+  DFRobot_ENS160::sTimedSnapshot_t s;
+  memset(&s, 0, sizeof(s));
+  s.timestamp = timestamp;
+  s.data.ECO2 = 400 + (timestamp & 0xFF);
+  return s;
+}
+
+static void testWrapAround(void)
+{
+  DFRobot_ENS160_SampleQueue<4> queue(NULL);
+  DFRobot_ENS160::sTimedSnapshot_t out[4];
+  uint32_t next = 0;
+
+  // 300 samples take the 8-bit indices across their wrap several times
+  for(uint32_t t = 0; t < 300; t += 3) {
+    CHECK(queue.push(sample(t)));
+    CHECK(queue.push(sample(t + 1)));
+    CHECK(queue.push(sample(t + 2)));
+    CHECK_EQ(queue.available(), 3);
+    CHECK_EQ(queue.drain(out, 2), 2);
+    CHECK_EQ(queue.drain(out + 2, 4), 1);
+    for(uint8_t i = 0; i < 3; i++, next++) {
+      CHECK_EQ(out[i].timestamp, next);
+      CHECK_EQ(out[i].data.ECO2, 400 + (next & 0xFF));
+    }
+  }
+  CHECK_EQ(queue.available(), 0);
+  CHECK_EQ(queue.getOverrunCount(), 0);
+}
+
+static void testOverrun(void)
+{
+  DFRobot_ENS160_SampleQueue<4> queue(NULL);
+  DFRobot_ENS160::sTimedSnapshot_t out[8];
+
+  for(uint32_t t = 0; t < 6; t++) {
+    CHECK_EQ(queue.push(sample(t)), t < 4);
+  }
+  CHECK_EQ(queue.getOverrunCount(), 2);
+  CHECK_EQ(queue.drain(out, 8), 4);
+  CHECK_EQ(out[0].timestamp, 0);   // The oldest are kept, the newest dropped
+  CHECK_EQ(out[3].timestamp, 3);
+  CHECK(queue.push(sample(6)));
+  CHECK_EQ(queue.drain(out, 8), 1);
+  CHECK_EQ(out[0].timestamp, 6);
+}
+
+static void testServiceCounters(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_SampleQueue<2> queue(&sim);
+  DFRobot_ENS160::sTimedSnapshot_t out[2];
+  sim.setEnvironment(1, 50, 450);
+  sim.begin();
+  advance(ENS160_SIM_PERIOD);
+
+  CHECK(!queue.service());   // Nothing pending
+  queue.onDataReady();
+  uint32_t readyTime = millis();
+  advance(5);
+  CHECK(queue.service());
+  CHECK_EQ(queue.drain(out, 2), 1);
+  CHECK_EQ(out[0].timestamp, readyTime);
+  CHECK_EQ(out[0].data.ECO2, 450);
+
+  queue.onDataReady();
+  queue.onDataReady();   // Before the first one was serviced
+  CHECK_EQ(queue.getMissedCount(), 1);
+  sim.injectReadErrors(1);
+  CHECK(!queue.service());
+  CHECK_EQ(queue.getReadErrCount(), 1);
+  CHECK(!queue.service());   // The failed read cleared the pending flag
+
+  for(uint8_t i = 0; i < 3; i++) {
+    queue.onDataReady();
+    queue.service();
+  }
+  CHECK_EQ(queue.available(), 2);
+  CHECK_EQ(queue.getOverrunCount(), 1);
+  CHECK_EQ(queue.getMissedCount(), 1);
+}
+
+int main(void)
+{
+  RUN_TEST(testWrapAround);
+  RUN_TEST(testOverrun);
+  RUN_TEST(testServiceCounters);
+  return testResult();
+}
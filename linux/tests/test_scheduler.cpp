@@ -0,0 +1,133 @@
+/*!
+ * @file  test_scheduler.cpp
+ * @brief  Unit tests of DFRobot_ENS160_Scheduler against the simulated sensor
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "DFRobot_ENS160_Sim.h"
+#include "DFRobot_ENS160_Scheduler.h"
+
+#define INTERVAL   600000   // One sample every 10 minutes
+#define STEP       100   // step() call period, unit: ms
+
+/* Run the scheduler until the next sample, returns the time it was delivered */
+static uint32_t nextSample(DFRobot_ENS160_Scheduler &scheduler, DFRobot_ENS160::sSnapshot_t *sample)
+{
+  for(uint32_t i = 0; i < 2 * INTERVAL / STEP; i++) {
+    if(scheduler.step(sample)) {
+      return millis();
+    }
+    advance(STEP);
+  }
+  CHECK(false);   // No sample within two intervals
+  return 0;
+}
+
+static void testDutyCycle(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Scheduler scheduler(&sim);
+  DFRobot_ENS160_Scheduler::sEnergyStats_t stats;
+  DFRobot_ENS160::sSnapshot_t sample;
+  sim.begin();
+  sim.setPWRMode(ENS160_SLEEP_MODE);
+  uint32_t start = millis();
+  scheduler.begin(INTERVAL);
+
+  // The first warm-up is the full one and is not learned
+  uint32_t t = nextSample(scheduler, &sample);
+  CHECK_EQ(sample.status.validityFlag, DFRobot_ENS160::eNormalOperation);
+  CHECK(t - start >= ENS160_SIM_WARM_UP_TIME);
+  CHECK(t - start < ENS160_SIM_WARM_UP_TIME + 2 * ENS160_SCHED_CHECK);
+  CHECK_EQ(sim.getCachedPWRMode(), ENS160_SLEEP_MODE);
+  CHECK(scheduler.isDutyCycling());
+  CHECK_EQ(scheduler.getSleepTime(), 0);   // Switching to DEEP SLEEP
+  advance(ENS160_SWITCH_TIME);
+  scheduler.step(&sample);
+  CHECK_EQ(scheduler.getSleepTime(), start + INTERVAL - ENS160_SCHED_WARM_UP - millis());   // Heater on in time
+
+  // The next ones are on the interval grid, heated only as long as the sensor needs
+  for(uint8_t i = 1; i <= 3; i++) {
+    t = nextSample(scheduler, &sample);
+    CHECK_EQ(sample.status.validityFlag, DFRobot_ENS160::eNormalOperation);
+    CHECK(t - start >= i * INTERVAL);
+    CHECK(t - start < i * INTERVAL + 2 * ENS160_SCHED_CHECK);
+  }
+  scheduler.getEnergyStats(&stats);
+  CHECK_EQ(stats.samples, 4);
+  CHECK_EQ(stats.wakeUps, 3);
+  CHECK(stats.warmUpTime >= ENS160_SIM_WARM_UP_TIME + ENS160_SCHED_MARGIN);
+  CHECK(stats.warmUpTime <= ENS160_SIM_WARM_UP_TIME + ENS160_SCHED_MARGIN + 2 * ENS160_SCHED_CHECK);
+
+  // Energy: 4 heating phases of about the warm-up time, asleep for the rest
+  uint32_t total = millis() - start;
+  CHECK_EQ(stats.sleepTime + stats.idleTime + stats.standardTime, total);
+  CHECK(stats.standardTime >= 4 * ENS160_SIM_WARM_UP_TIME);
+  CHECK(stats.standardTime <= 4 * (ENS160_SIM_WARM_UP_TIME + 2 * ENS160_SCHED_CHECK));
+  float energy = ((float)stats.sleepTime * ENS160_SCHED_SLEEP_POWER +
+                  (float)stats.standardTime * ENS160_SCHED_STANDARD_POWER) / 1000000.0;
+  CHECK(fabs(stats.energy - energy) < 0.01);
+  CHECK(stats.energy < (float)total * ENS160_SCHED_STANDARD_POWER / 1000000.0 / 2);   // Less than half of always on
+}
+
+static void testLeadTimeShrinks(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Scheduler scheduler(&sim);
+  DFRobot_ENS160_Scheduler::sEnergyStats_t stats;
+  DFRobot_ENS160::sSnapshot_t sample;
+  sim.begin();
+  scheduler.begin(INTERVAL);
+  nextSample(scheduler, &sample);
+  nextSample(scheduler, &sample);
+  scheduler.getEnergyStats(&stats);
+  uint32_t lead = stats.warmUpTime;
+
+  // The scheduler checks a bit before the learned time, so the lead follows a shorter warm-up down
+  for(uint8_t i = 0; i < 3; i++) {
+    nextSample(scheduler, &sample);
+  }
+  scheduler.getEnergyStats(&stats);
+  CHECK(stats.warmUpTime <= lead);
+  CHECK(stats.warmUpTime >= ENS160_SIM_WARM_UP_TIME);
+}
+
+static void testShortInterval(void)
+{
+  DFRobot_ENS160_Sim sim;
+  DFRobot_ENS160_Scheduler scheduler(&sim);
+  DFRobot_ENS160::sSnapshot_t sample;
+  sim.begin();
+  scheduler.begin(10000);
+  nextSample(scheduler, &sample);
+  CHECK(!scheduler.isDutyCycling());   // Shorter than a warm-up: the heater stays on
+  CHECK_EQ(sim.getCachedPWRMode(), ENS160_STANDARD_MODE);
+  uint32_t t = nextSample(scheduler, &sample);
+  CHECK_EQ(nextSample(scheduler, &sample) - t, 10000);
+}
+
+static void testUnknownMode(void)
+{
+  DFRobot_ENS160_Sim sim;   // begin() not called: the mode is not known
+  DFRobot_ENS160_Scheduler scheduler(&sim);
+  DFRobot_ENS160_Scheduler::sEnergyStats_t stats;
+  advance(1000);
+  scheduler.getEnergyStats(NULL);
+  scheduler.getEnergyStats(&stats);
+  CHECK_EQ(stats.sleepTime + stats.idleTime + stats.standardTime, 0);
+  CHECK_EQ(stats.energy, 0);
+}
+
+int main(void)
+{
+  RUN_TEST(testDutyCycle);
+  RUN_TEST(testLeadTimeShrinks);
+  RUN_TEST(testShortInterval);
+  RUN_TEST(testUnknownMode);
+  return testResult();
+}
@@ -0,0 +1,448 @@
+/*!
+ * @file  test_sim.cpp
+ * @brief  Unit tests of the driver against the simulated ENS160
+ * @details  OPMODE transitions, STATUS validity phases, MISR tracking, GPR and GET_APPVER, and the
+ * @n        transactions and I2C wire bytes each API costs, so that a change of a register access path
+ * @n        fails the build.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license  The MIT License (MIT)
+ * @author  [qsjhyy](yihuan.huang@dfrobot.com)
+ * @version  V1.0
+ * @date  2021-10-26
+ * @url  https://github.com/DFRobot/DFRobot_ENS160
+ */
+#include "ens160_test.h"
+#include "ens160_test_sim.h"
+#include "DFRobot_ENS160_Fast.h"
+
+/* Bus of DFRobot_ENS160_Fast on the simulated sensor */
+struct SimBus
+{
+  TestSim *sim;
+  void begin(void) {}
+  size_t readReg(uint8_t reg, void *pBuf, size_t size) { return sim->readReg(reg, pBuf, size); }
+  void writeReg(uint8_t reg, const void *pBuf, size_t size) { sim->writeReg(reg, pBuf, size); }
+};
+
+/* Status bits as the chip reports them */
+#define STATUS_STATAS   0x80
+#define STATUS_STATER   0x40
+#define STATUS_VALIDITY(status)   (((status) >> 2) & 0x03)
+
+/* Bus cost of one call */
+typedef struct
+{
+  uint32_t transactions;
+  uint32_t wireBytes;
+} sCost_t;
+
+static sCost_t costSince(TestSim &sim, const DFRobot_ENS160_Sim::sSimStats_t &start)
+{
+  DFRobot_ENS160_Sim::sSimStats_t now;
+  sim.getSimStats(&now);
+  sCost_t cost;
+  cost.transactions = (now.readTransactions + now.writeTransactions) - (start.readTransactions + start.writeTransactions);
+  cost.wireBytes = now.wireBytes - start.wireBytes;
+  return cost;
+}
+
+#define CHECK_COST(sim, call, expTransactions, expWireBytes)   do { \
+    DFRobot_ENS160_Sim::sSimStats_t _start; \
+    (sim).getSimStats(&_start); \
+    call; \
+    sCost_t _cost = costSince((sim), _start); \
+    CHECK_EQ(_cost.transactions, (expTransactions)); \
+    CHECK_EQ(_cost.wireBytes, (expWireBytes)); \
+  } while(0)
+
+static void testOPModeTransitions(void)
+{
+  TestSim sim;
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_SLEEP_MODE);   // Power-on state
+  CHECK_EQ(sim.peekReg(ENS160_DATA_STATUS_REG) & STATUS_STATAS, 0);
+
+  CHECK_EQ(sim.begin(), NO_ERR);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+  CHECK(sim.peekReg(ENS160_DATA_STATUS_REG) & STATUS_STATAS);
+  CHECK_EQ(sim.peekReg(ENS160_CONFIG_REG), DFRobot_ENS160::eINTDataDrdyEN);
+
+  sim.setPWRMode(ENS160_IDLE_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_IDLE_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_DATA_STATUS_REG) & STATUS_STATAS, 0);
+  CHECK_EQ(sim.getCachedPWRMode(), ENS160_IDLE_MODE);
+
+  sim.setPWRMode(ENS160_SLEEP_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_SLEEP_MODE);
+
+  sim.setPWRMode(ENS160_STANDARD_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+  CHECK(sim.peekReg(ENS160_DATA_STATUS_REG) & STATUS_STATAS);
+
+  sim.writeByte(ENS160_OPMODE_REG, 0x05);   // Invalid operating mode
+  CHECK(sim.peekReg(ENS160_DATA_STATUS_REG) & STATUS_STATER);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+
+  sim.writeByte(ENS160_OPMODE_REG, ENS160_SIM_RESET_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_SLEEP_MODE);
+  CHECK_EQ(sim.peekReg(ENS160_DATA_STATUS_REG) & STATUS_STATER, 0);
+}
+
+static void testValidityPhases(void)
+{
+  TestSim sim;
+  CHECK_EQ(STATUS_VALIDITY(sim.peekReg(ENS160_DATA_STATUS_REG)), DFRobot_ENS160::eInvalidOutput);
+  sim.begin();
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eWarmUpPhase);
+  advance(ENS160_SIM_WARM_UP_TIME - 1000);
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eWarmUpPhase);
+  advance(1000);
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eNormalOperation);
+
+  // Leaving STANDARD mode starts the warm-up over
+  sim.setPWRMode(ENS160_IDLE_MODE);
+  sim.setPWRMode(ENS160_STANDARD_MODE);
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eWarmUpPhase);
+
+  // Initial Start-Up: first hour of the sensor's life, only once
+  TestSim fresh;
+  fresh.setInitialStartUp(true);
+  fresh.begin();
+  CHECK_EQ(fresh.getENS160Status(), DFRobot_ENS160::eInitialStartUpPhase);
+  advance(ENS160_SIM_START_UP_TIME);
+  CHECK_EQ(fresh.getENS160Status(), DFRobot_ENS160::eNormalOperation);
+  fresh.setPWRMode(ENS160_IDLE_MODE);
+  fresh.setPWRMode(ENS160_STANDARD_MODE);
+  CHECK_EQ(fresh.getENS160Status(), DFRobot_ENS160::eWarmUpPhase);
+}
+
+static void testMeasuredData(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  sim.setEnvironment(3, 456, 789);
+  sim.begin();
+  advance(ENS160_SIM_PERIOD);
+
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+  CHECK_EQ(snapshot.AQI, 3);
+  CHECK_EQ(snapshot.TVOC, 456);
+  CHECK_EQ(snapshot.ECO2, 789);
+  CHECK_EQ(snapshot.stale, 0);
+  CHECK_EQ(snapshot.status.dataDrdy, 1);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+  CHECK_EQ(snapshot.status.dataDrdy, 0);   // NEWDAT is cleared by the first read
+  CHECK_EQ(sim.getAQI(), 3);
+  CHECK_EQ(sim.getTVOC(), 456);
+  CHECK_EQ(sim.getECO2(), 789);
+
+  sim.injectReadErrors(1);
+  CHECK_EQ(sim.readSnapshot(&snapshot), ERR_DATA_BUS);
+  CHECK_EQ(snapshot.stale, 1);
+  CHECK_EQ(snapshot.TVOC, 456);   // The last good sample
+  sim.injectReadErrors(1);
+  CHECK_EQ(sim.getTVOC(), 0);   // No stack garbage on a failed read
+}
+
+static void testMISRTracking(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  DFRobot_ENS160::sMISRStats_t stats;
+  sim.begin();
+  sim.setMISRCheck(true);
+
+  for(uint8_t i = 0; i < 10; i++) {
+    advance(ENS160_SIM_PERIOD);
+    sim.setEnvironment(1 + i % 5, 100 * i, 400 + 50 * i);
+    CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);
+    sim.getAQI();   // The single value getters keep the mirror in step too
+    sim.getENS160Status();
+  }
+  sim.getMISRStats(&stats);
+  CHECK_EQ(stats.checked, 10);
+  CHECK_EQ(stats.mismatch, 0);
+
+  sim.injectBitError();
+  CHECK_EQ(sim.readSnapshot(&snapshot), ERR_MISR_CHECK);
+  CHECK_EQ(sim.readSnapshot(&snapshot), NO_ERR);   // Resynchronized
+  sim.getMISRStats(&stats);
+  CHECK_EQ(stats.checked, 12);
+  CHECK_EQ(stats.mismatch, 1);
+}
+
+static DFRobot_ENS160::sAppVersion_t appVersion;
+static int appVersionResult = 1;
+static uint8_t commandsDone = 0;
+
+static void onCommand(uint8_t command, int result, const uint8_t *gpr)
+{
+  if(ENS160_COMMAND_GET_APPVER == command) {
+    appVersionResult = result;
+    DFRobot_ENS160::decodeAppVersion(gpr, &appVersion);
+  }
+  commandsDone++;
+}
+
+static void testGPRAndCommands(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sGPRData_t gpr;
+  sim.setEnvironment(1, 0x155, 400);
+  sim.begin();
+  advance(ENS160_SIM_PERIOD);
+
+  CHECK_EQ(sim.readGPR(&gpr), NO_ERR);
+  CHECK_EQ(gpr.hp0Raw, 0x3000 + 0x155);
+  CHECK_EQ(gpr.hp3Raw, 0x3000 + (3 << 10) + 0x155);
+  CHECK(sim.rawToOhm(0x3000) > 50.0);   // 2^6
+
+  CHECK(sim.queueCommand(ENS160_COMMAND_GET_APPVER, onCommand));
+  CHECK(sim.queueCommand(ENS160_COMMAND_CLRGPR, onCommand));
+  CHECK_EQ(sim.getCommandCount(), 2);
+  CHECK(!sim.isReady());
+  while(!sim.poll()) {
+    yield();
+  }
+  CHECK_EQ(commandsDone, 2);
+  CHECK_EQ(appVersionResult, NO_ERR);
+  CHECK_EQ(appVersion.major, 5);
+  CHECK_EQ(appVersion.minor, 4);
+  CHECK_EQ(appVersion.release, 6);
+  while(!sim.isReady()) {
+    sim.poll();
+    yield();
+  }
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);   // Restored after the commands
+  CHECK_EQ(sim.peekReg(ENS160_GPR_READ_REG + 4), 0);   // CLRGPR
+}
+
+static TestSim *callbackSim = NULL;
+
+static void onCommandQueueMore(uint8_t command, int result, const uint8_t *gpr)
+{
+  onCommand(command, result, gpr);
+  if(ENS160_COMMAND_GET_APPVER == command) {
+    callbackSim->queueCommand(ENS160_COMMAND_NOP, onCommand);   // Joins the running IDLE phase
+  }
+}
+
+static void runCommands(TestSim &sim)
+{
+  while(!sim.isReady()) {
+    sim.poll();
+    yield();
+  }
+}
+
+static void testCommandBatching(void)
+{
+  TestSim sim;
+  callbackSim = &sim;
+  sim.begin();
+  sim.idleWrites = 0;
+  sim.modeWrites = 0;
+  commandsDone = 0;
+
+  // Queued together and from a callback: one IDLE phase
+  sim.queueCommand(ENS160_COMMAND_CLRGPR, onCommand);
+  sim.queueCommand(ENS160_COMMAND_GET_APPVER, onCommandQueueMore);
+  runCommands(sim);
+  CHECK_EQ(commandsDone, 3);
+  CHECK_EQ(sim.idleWrites, 1);
+  CHECK_EQ(sim.modeWrites, 2);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+
+  // Queued after the last command, before the switch back is written
+  sim.modeWrites = 0;
+  sim.idleWrites = 0;
+  sim.queueCommand(ENS160_COMMAND_NOP, NULL);
+  while(sim.getCommandCount()) {
+    sim.poll();
+    yield();
+  }
+  sim.queueCommand(ENS160_COMMAND_CLRGPR, NULL);
+  runCommands(sim);
+  CHECK_EQ(sim.idleWrites, 1);
+  CHECK_EQ(sim.modeWrites, 2);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+}
+
+static void testCommandFoldsPendingMode(void)
+{
+  TestSim sim;
+  sim.begin();
+  sim.setPWRModeAsync(ENS160_IDLE_MODE);   // Written, the sensor is switching
+  sim.setPWRModeAsync(ENS160_STANDARD_MODE);   // Waits for the switch
+  sim.queueCommand(ENS160_COMMAND_GET_APPVER, NULL);
+  runCommands(sim);
+  CHECK_EQ(sim.idleWrites, 1);
+  CHECK_EQ(sim.modeWrites, 3);   // STANDARD of begin(), IDLE, STANDARD after the command
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+}
+
+static void testSetPWRModeBlocking(void)
+{
+  TestSim sim;
+  sim.begin();
+
+  // Only the mode switch is waited for
+  uint32_t start = millis();
+  sim.setPWRMode(ENS160_IDLE_MODE);
+  CHECK_EQ(millis() - start, ENS160_SWITCH_TIME);
+  sim.setPWRMode(ENS160_STANDARD_MODE);
+
+  // Not the command queue: GET_APPVER may take up to ENS160_CMD_TIMEOUT
+  sim.queueCommand(ENS160_COMMAND_GET_APPVER, NULL);
+  sim.queueCommand(ENS160_COMMAND_GET_APPVER, NULL);
+  start = millis();
+  sim.setINTMode(DFRobot_ENS160::eINTModeEN);
+  CHECK(millis() - start <= ENS160_SWITCH_TIME);
+  CHECK_EQ(sim.getCommandCount(), 2);
+  sim.setPWRMode(ENS160_SLEEP_MODE);   // Switched to after the commands
+  CHECK(millis() - start <= 2 * ENS160_SWITCH_TIME);
+  CHECK(sim.getCommandCount() > 0);
+  runCommands(sim);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_SLEEP_MODE);
+}
+
+static void testWarmStart(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sWarmState_t state;
+  sim.getWarmState(NULL);
+  sim.getWarmState(&state);
+  CHECK_EQ(state.magic, 0);   // Nothing verified yet
+
+  sim.begin();
+  advance(100000);
+  sim.getWarmState(&state);
+  CHECK_EQ(state.magic, ENS160_WARM_MAGIC);
+  CHECK_EQ(state.opMode, ENS160_STANDARD_MODE);
+  CHECK_EQ(state.validity, DFRobot_ENS160::eInvalidOutput);   // DATA_STATUS never read
+
+  // PART_ID, then OPMODE and CONFIG; no writes, the warm-up goes on
+  sim.modeWrites = 0;
+  CHECK_COST(sim, CHECK_EQ(sim.beginWarm(&state, 1000), NO_ERR), 2, (3 + 2) + (3 + 2));
+  CHECK_EQ(sim.modeWrites, 0);
+  CHECK(sim.getHeaterOnTime() >= 101000);
+
+  // The sensor was power cycled too: cold start
+  sim.powerCycle();
+  CHECK_EQ(sim.beginWarm(&state), NO_ERR);
+  CHECK_EQ(sim.modeWrites, 1);
+  CHECK_EQ(sim.peekReg(ENS160_OPMODE_REG), ENS160_STANDARD_MODE);
+  CHECK(sim.getHeaterOnTime() < 1000);
+
+  sim.getWarmState(&state);
+  sim.injectReadErrors(1);
+  CHECK_EQ(sim.beginWarm(&state), ERR_DATA_BUS);
+  state.checksum ^= 0xFF;
+  CHECK_EQ(sim.beginWarm(&state), NO_ERR);   // Corrupted state: cold start
+  CHECK_EQ(sim.beginWarm(NULL), NO_ERR);
+}
+
+static void testWarmStartPhase(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sWarmState_t state;
+  sim.begin();
+  advance(ENS160_SIM_WARM_UP_TIME + 1000);
+  CHECK_EQ(sim.getENS160Status(), DFRobot_ENS160::eNormalOperation);
+  sim.getWarmState(&state);
+  CHECK_EQ(state.validity, DFRobot_ENS160::eNormalOperation);
+
+  // DATA_STATUS is checked as well; the command queue starts empty like after begin()
+  sim.queueCommand(ENS160_COMMAND_GET_APPVER, NULL);
+  CHECK_EQ(sim.getCommandCount(), 1);
+  sim.modeWrites = 0;
+  CHECK_COST(sim, CHECK_EQ(sim.beginWarm(&state), NO_ERR), 3, (3 + 2) + (3 + 2) + (3 + 1));
+  CHECK_EQ(sim.modeWrites, 0);
+  CHECK_EQ(sim.getCommandCount(), 0);
+  CHECK(sim.poll());
+  CHECK(sim.getCacheFlags() & ENS160_CACHE_STATUS);
+
+  // Reset and set up again by someone else: same OPMODE and CONFIG, but back in Warm-Up
+  sim.powerCycle();
+  sim.writeByte(ENS160_OPMODE_REG, state.opMode);
+  sim.writeByte(ENS160_CONFIG_REG, state.config);
+  sim.modeWrites = 0;
+  CHECK_EQ(sim.beginWarm(&state), NO_ERR);
+  CHECK_EQ(sim.modeWrites, 1);   // Cold start
+  CHECK(sim.getHeaterOnTime() < 1000);
+}
+
+static void testFastDriver(void)
+{
+  TestSim sim;
+  SimBus bus = {&sim};
+  DFRobot_ENS160_Fast<SimBus> fast(bus);
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  sim.setEnvironment(2, 120, 500);
+  CHECK_EQ(fast.begin(), NO_ERR);
+  CHECK_EQ(fast.readSnapshot(NULL), ERR_DATA_BUS);
+  advance(ENS160_SIM_PERIOD);
+  CHECK_EQ(fast.readSnapshot(&snapshot), NO_ERR);
+  CHECK_EQ(snapshot.ECO2, 500);
+
+  // Same conversion and clamping as the virtual driver
+  fast.setTempAndHumFixed(2500, 5000);
+  CHECK_EQ(ENS160_CONCAT_BYTES(sim.peekReg(ENS160_TEMP_IN_REG + 1), sim.peekReg(ENS160_TEMP_IN_REG)), 19081);
+  CHECK_EQ(ENS160_CONCAT_BYTES(sim.peekReg(ENS160_RH_IN_REG + 1), sim.peekReg(ENS160_RH_IN_REG)), 25600);
+  fast.setTempAndHumFixed(-5000, 12000);
+  uint16_t temp, rh;
+  DFRobot_ENS160::encodeTempAndHum(-4000, 10000, &temp, &rh);
+  CHECK_EQ(ENS160_CONCAT_BYTES(sim.peekReg(ENS160_TEMP_IN_REG + 1), sim.peekReg(ENS160_TEMP_IN_REG)), temp);
+  CHECK_EQ(ENS160_CONCAT_BYTES(sim.peekReg(ENS160_RH_IN_REG + 1), sim.peekReg(ENS160_RH_IN_REG)), rh);
+  CHECK_EQ(sim.compWrites, 2);
+}
+
+static void testBusCost(void)
+{
+  TestSim sim;
+  DFRobot_ENS160::sSnapshot_t snapshot;
+  DFRobot_ENS160::sGPRData_t gpr;
+
+  // Read PART_ID (2 bytes), write OPMODE, write CONFIG
+  CHECK_COST(sim, sim.begin(), 3, (3 + 2) + (2 + 1) + (2 + 1));
+  advance(ENS160_SIM_PERIOD);
+
+  CHECK_COST(sim, sim.getENS160Status(), 1, 3 + 1);
+  CHECK_COST(sim, sim.getAQI(), 1, 3 + 1);
+  CHECK_COST(sim, sim.getTVOC(), 1, 3 + 2);
+  CHECK_COST(sim, sim.getECO2(), 1, 3 + 2);
+  CHECK_COST(sim, sim.readSnapshot(&snapshot), 1, 3 + 6);
+  CHECK_COST(sim, sim.readGPR(&gpr), 1, 3 + 8);
+
+  sim.setMISRCheck(true);
+  CHECK_COST(sim, sim.readSnapshot(&snapshot), 2, (3 + 6) + (3 + 1));
+  sim.setMISRCheck(false);
+
+  // The shadow cache skips writes of unchanged values
+  CHECK_COST(sim, sim.setPWRMode(ENS160_STANDARD_MODE), 0, 0);
+  CHECK_COST(sim, sim.setINTMode(0), 0, 0);
+  CHECK_COST(sim, sim.setTempAndHum(25.0, 50.0), 1, 2 + 4);
+  CHECK_COST(sim, sim.setTempAndHum(25.0, 50.0), 0, 0);
+  CHECK_COST(sim, sim.setPWRMode(ENS160_IDLE_MODE), 1, 2 + 1);
+
+  // Rate-limited compensation
+  CHECK_COST(sim, sim.updateTempAndHum(2200, 4000), 1, 2 + 4);
+  CHECK_COST(sim, sim.updateTempAndHum(2210, 4050), 0, 0);
+  CHECK_COST(sim, sim.resyncCache(), 3, (3 + 2) + (3 + 4) + (3 + 1));
+}
+
+int main(void)
+{
+  RUN_TEST(testOPModeTransitions);
+  RUN_TEST(testValidityPhases);
+  RUN_TEST(testMeasuredData);
+  RUN_TEST(testMISRTracking);
+  RUN_TEST(testGPRAndCommands);
+  RUN_TEST(testCommandBatching);
+  RUN_TEST(testCommandFoldsPendingMode);
+  RUN_TEST(testSetPWRModeBlocking);
+  RUN_TEST(testWarmStart);
+  RUN_TEST(testWarmStartPhase);
+  RUN_TEST(testFastDriver);
+  RUN_TEST(testBusCost);
+  return testResult();
+}
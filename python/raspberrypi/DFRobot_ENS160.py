@@ -15,9 +15,12 @@
 import sys
 import time
 
-import smbus
-import spidev
-import RPi.GPIO as GPIO
+try:
+    import smbus
+    import spidev
+    import RPi.GPIO as GPIO
+except ImportError:   # Off the Pi the drivers still work on an injected bus object
+    smbus = spidev = GPIO = None
 
 import logging
 from ctypes import *
@@ -87,6 +90,9 @@ ENS160_COMMAND_GET_APPVER = 0x0E
 ## Clears GPR Read Registers Command.
 ENS160_COMMAND_CLRGPR = 0xCC
 
+## Length of one sample burst: DATA_STATUS, DATA_AQI, DATA_TVOC(2), DATA_ECO2(2)
+ENS160_SAMPLE_LEN = 6
+
 
 class DFRobot_ENS160(object):
     '''!
@@ -183,6 +189,17 @@ class DFRobot_ENS160(object):
         '''
         self.misr = 0   # Mirror of DATA_MISR (0 is hardware default)
         self.sensor_status = self.sensor_status()   # The structure class for storing the sensor status, uint8_t
+        self._fast = False   # High-throughput mode, see set_fast_mode()
+
+    def set_fast_mode(self, enable=True):
+        '''!
+          @brief Enable or disable the high-throughput mode
+          @details In this mode set_PWR_mode()/set_INT_mode() return without the 20 ms settle time and every
+          @n       register read is a single bus transaction without sleeps. Use it with read_sample() on
+          @n       gateways that poll many sensors.
+          @param enable True to enable, False to restore the default timing
+        '''
+        self._fast = enable
 
     def begin(self):
         '''!
@@ -209,7 +226,8 @@ class DFRobot_ENS160(object):
           @n       ENS160_STANDARD_MODE: STANDARD Gas Sensing Modes
         '''
         self._write_reg(ENS160_OPMODE_REG, mode)
-        time.sleep(0.02)
+        if not self._fast:
+            time.sleep(0.02)
 
     def set_INT_mode(self, mode):
         '''!
@@ -221,7 +239,8 @@ class DFRobot_ENS160(object):
         '''
         mode |= (self.e_INT_data_drdy_EN | self.e_INT_GPR_drdy_DIS)
         self._write_reg(ENS160_CONFIG_REG, mode)
-        time.sleep(0.02)
+        if not self._fast:
+            time.sleep(0.02)
 
     def set_temp_and_hum(self, ambient_temp, relative_humidity):
         '''!
@@ -295,6 +314,24 @@ class DFRobot_ENS160(object):
         buf = self._read_reg(ENS160_DATA_ECO2_REG, 2)
         return ((buf[1] << 8) | buf[0])
 
+    def read_sample(self):
+        '''!
+          @brief Read status, AQI, TVOC and eCO2 with one burst read
+          @return dict with timestamp (s, time.time() after the read), status (raw DATA_STATUS byte),
+          @n      validity_flag, new_data, AQI, TVOC (ppb) and ECO2 (ppm)
+        '''
+        buf = self._read_reg(ENS160_DATA_STATUS_REG, ENS160_SAMPLE_LEN)
+        if len(buf) != ENS160_SAMPLE_LEN:
+            raise IOError("short read from ENS160: %d bytes" %len(buf))
+        self.sensor_status.set_list(buf[0:1])
+        return dict(timestamp=time.time(),
+                    status=buf[0],
+                    validity_flag=self.sensor_status.validity_flag,
+                    new_data=self.sensor_status.data_drdy,
+                    AQI=buf[1],
+                    TVOC=(buf[3] << 8) | buf[2],
+                    ECO2=(buf[5] << 8) | buf[4])
+
     def _get_MISR(self):
         '''!
           @brief Get the current crc check code of the sensor
@@ -345,10 +382,16 @@ class DFRobot_ENS160_I2C(DFRobot_ENS160):
         '''!
           @brief Module I2C communication init
           @param i2c_addr I2C communication address
-          @param bus I2C bus
+          @param bus I2C bus number, or an object with the smbus methods write_i2c_block_data() and
+          @n         read_i2c_block_data() (an already opened SMBus, or a fake bus for testing)
         '''
         self._addr = i2c_addr
-        self.i2c = smbus.SMBus(bus)
+        if isinstance(bus, int):
+            self.i2c = smbus.SMBus(bus)
+            self.bus_key = ("i2c", bus)   # Sensors with the same key share the wires, see DFRobot_ENS160_Gateway
+        else:
+            self.i2c = bus
+            self.bus_key = ("i2c", id(bus))
         super(DFRobot_ENS160_I2C, self).__init__()
 
     def _write_reg(self, reg, data):
@@ -378,25 +421,41 @@ class DFRobot_ENS160_SPI(DFRobot_ENS160):
       @details Use SPI protocol to drive the pressure sensor
     '''
 
-    def __init__(self, cs=8, bus=0, dev=0, speed=2000000):
+    def __init__(self, cs=8, bus=0, dev=0, speed=2000000, spi=None):
         '''!
           @brief Module SPI communication init
-          @param cs cs chip select pin
+          @param cs cs chip select pin, None to let the SPI controller drive its own CE line
           @param bus SPI bus 
           @param dev SPI device number
           @param speed SPI communication frequency
+          @param spi An object with the spidev methods xfer(), xfer2() and readbytes() to use instead of
+          @n         opening /dev/spidev<bus>.<dev> (an already opened SpiDev, or a fake bus for testing)
         '''
         self._cs = cs
-        GPIO.setmode(GPIO.BCM)
-        GPIO.setwarnings(False)
-        GPIO.setup(self._cs, GPIO.OUT, initial=1)
-        GPIO.output(self._cs, GPIO.LOW)
-        self.spi = spidev.SpiDev()
-        self.spi.open(bus, dev)
-        self.spi.no_cs = True
-        self.spi.max_speed_hz = speed
+        if self._cs is not None:
+            GPIO.setmode(GPIO.BCM)
+            GPIO.setwarnings(False)
+            GPIO.setup(self._cs, GPIO.OUT, initial=1)
+            GPIO.output(self._cs, GPIO.LOW)
+        if spi is None:
+            self.spi = spidev.SpiDev()
+            self.spi.open(bus, dev)
+            self.spi.no_cs = self._cs is not None
+            self.spi.max_speed_hz = speed
+            self.bus_key = ("spi", bus)   # All devices and chip selects of a controller share its wires
+        else:
+            self.spi = spi
+            self.bus_key = ("spi", id(spi))
         super(DFRobot_ENS160_SPI, self).__init__()
 
+    def _select(self, level):
+        '''!
+          @brief Drive the chip select pin, if it is a GPIO
+          @param level GPIO.LOW or GPIO.HIGH
+        '''
+        if self._cs is not None:
+            GPIO.output(self._cs, level)
+
     def _write_reg(self, reg, data):
         '''!
           @brief writes data to a register
@@ -407,6 +466,11 @@ class DFRobot_ENS160_SPI(DFRobot_ENS160):
             data = [data]
             #logger.info(data)
         reg_addr = [(reg << 1) & 0xFE]
+        if self._fast or self._cs is None:
+            self._select(0)
+            self.spi.xfer2(reg_addr + list(data))
+            self._select(1)
+            return
         GPIO.output(self._cs, GPIO.LOW)
         self.spi.xfer(reg_addr)
         self.spi.xfer(data)
@@ -420,6 +484,12 @@ class DFRobot_ENS160_SPI(DFRobot_ENS160):
           @return read data list
         '''
         reg_addr = [(reg << 1) | 0x01]
+        if self._fast or self._cs is None:
+            # Address and data in one transfer, chip select held for the whole burst
+            self._select(0)
+            rslt = self.spi.xfer2(reg_addr + [0] * length)
+            self._select(1)
+            return rslt[1:]
         GPIO.output(self._cs, GPIO.LOW)
         #logger.info(reg_addr)
         self.spi.xfer(reg_addr)
@@ -0,0 +1,91 @@
+# -*- coding: utf-8 -*
+'''!
+  @file  DFRobot_ENS160_Codec.py
+  @brief  Decoder for the blocks written by DFRobot_ENS160_Encoder
+  @details  Gateways and servers use it to unpack logged or uplinked samples. It has no hardware dependencies.
+  @n        A block is: version (0xE1), flags, number of samples, then one record per sample. A record is a
+  @n        mask byte followed by the zig-zag varint delta of every field whose bit is set in the mask;
+  @n        the timestamp is coded as delta of delta.
+  @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license  The MIT License (MIT)
+  @author  [qsjhyy](yihuan.huang@dfrobot.com)
+  @version  V1.0
+  @date  2021-10-28
+  @url  https://github.com/DFRobot/DFRobot_ENS160
+'''
+
+## Format version, first byte of a block
+ENS160_CODEC_VERSION = 0xE1
+## Header flag: the block carries temperature and humidity
+ENS160_CODEC_TEMP_HUM = 0x01
+
+## Fields in record order: name, mask bit, value mask
+_FIELDS = [
+    ("status", 0x02, 0xFF),
+    ("AQI", 0x04, 0xFF),
+    ("TVOC", 0x08, 0xFFFF),
+    ("ECO2", 0x10, 0xFFFF),
+    ("temp", 0x20, 0xFFFF),
+    ("hum", 0x40, 0xFFFF),
+]
+
+
+def _unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def _varint(data, pos):
+    result = 0
+    shift = 0
+    while True:
+        if pos >= len(data) or shift >= 35:
+            raise ValueError("truncated block")
+        byte = data[pos]
+        pos += 1
+        result |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return result, pos
+        shift += 7
+
+
+def decode_block(data):
+    '''!
+      @brief Decode one block
+      @param data  The block, bytes, bytearray or list of ints
+      @return List of samples, each a dict with timestamp (ms), status, AQI, TVOC (ppb), ECO2 (ppm)
+      @n      and, if the block carries them, temp (°C) and hum (%rH)
+      @exception ValueError  Not a block of this version or the block is truncated
+    '''
+    data = bytearray(data)
+    if len(data) < 3 or data[0] != ENS160_CODEC_VERSION:
+        raise ValueError("not an ENS160 codec block")
+    flags = data[1]
+    count = data[2]
+    pos = 3
+    prev = dict(timestamp=0, status=0, AQI=0, TVOC=0, ECO2=0, temp=0, hum=0)
+    delta = 0
+    samples = []
+    for _ in range(count):
+        if pos >= len(data):
+            raise ValueError("truncated block")
+        mask = data[pos]
+        pos += 1
+        s = dict(prev)
+        if mask & 0x01:
+            value, pos = _varint(data, pos)
+            delta = (delta + _unzigzag(value)) & 0xFFFFFFFF
+        s["timestamp"] = (prev["timestamp"] + delta) & 0xFFFFFFFF
+        for name, bit, width in _FIELDS:
+            if mask & bit:
+                value, pos = _varint(data, pos)
+                s[name] = (s[name] + _unzigzag(value)) & width
+        prev = s
+        out = dict(s)
+        if flags & ENS160_CODEC_TEMP_HUM:
+            temp = out["temp"] - 0x10000 if out["temp"] & 0x8000 else out["temp"]
+            out["temp"] = temp / 100.0
+            out["hum"] = out["hum"] / 100.0
+        else:
+            del out["temp"], out["hum"]
+        samples.append(out)
+    return samples
@@ -0,0 +1,104 @@
+# -*- coding: utf-8 -*
+'''!
+  @file  DFRobot_ENS160_Gateway.py
+  @brief  asyncio poller that reads many ENS160 sensors concurrently
+  @details  Every period each sensor is read with one burst (read_sample() in high-throughput mode) and the
+  @n        results are yielded together as one timestamped batch. Sensors on the same physical bus (the
+  @n        bus_key of the drivers: I2C bus number, or SPI controller whatever the device or chip select)
+  @n        are read one after another on the same worker thread, sensors on different buses in parallel.
+  @n        Requires Python 3.7 or later.
+  @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license  The MIT License (MIT)
+  @author  [qsjhyy](yihuan.huang@dfrobot.com)
+  @version  V1.0
+  @date  2021-10-28
+  @url  https://github.com/DFRobot/DFRobot_ENS160
+'''
+import asyncio
+import time
+
+
+def _bus_of(sensor):
+    '''!
+      @brief The physical bus of a sensor, sensors sharing it must not be read at the same time
+      @details The drivers set bus_key to ("i2c", bus number) or ("spi", bus number), or to the id of an
+      @n       injected bus object. Assign it yourself when several bus objects drive the same wires.
+    '''
+    key = getattr(sensor, "bus_key", None)
+    if key is not None:
+        return key
+    return id(getattr(sensor, "i2c", None) or getattr(sensor, "spi", None) or sensor)
+
+
+class DFRobot_ENS160_Gateway(object):
+    '''!
+      @brief Poll a set of DFRobot_ENS160 sensors from an asyncio event loop
+    '''
+
+    def __init__(self, sensors, period=1.0, executor=None):
+        '''!
+          @brief Gateway init
+          @param sensors dict of name: sensor, or a list of sensors (named by their index)
+          @param period Time between two batches, unit: s. The sensor updates its data once per second.
+          @param executor concurrent.futures executor for the blocking bus I/O, None uses the loop default
+        '''
+        if not isinstance(sensors, dict):
+            sensors = dict(enumerate(sensors))
+        self.period = period
+        self._executor = executor
+        self._groups = {}
+        for name, sensor in sensors.items():
+            sensor.set_fast_mode(True)
+            self._groups.setdefault(_bus_of(sensor), []).append((name, sensor))
+
+    @staticmethod
+    def _read_group(group):
+        '''!
+          @brief Read the sensors of one bus in turn, runs on a worker thread
+          @return list of (name, sample or exception)
+        '''
+        result = []
+        for name, sensor in group:
+            try:
+                result.append((name, sensor.read_sample()))
+            except Exception as e:   # One bad sensor must not stop the others
+                result.append((name, e))
+        return result
+
+    async def read_batch(self):
+        '''!
+          @brief Read every sensor once
+          @return dict with timestamp (s, time.time() when the batch was started), samples (name: sample dict
+          @n      as returned by read_sample()) and errors (name: exception) for the sensors that failed
+        '''
+        loop = asyncio.get_running_loop()
+        timestamp = time.time()
+        results = await asyncio.gather(*[loop.run_in_executor(self._executor, self._read_group, group)
+                                         for group in self._groups.values()])
+        batch = dict(timestamp=timestamp, samples={}, errors={})
+        for group in results:
+            for name, sample in group:
+                if isinstance(sample, Exception):
+                    batch["errors"][name] = sample
+                else:
+                    batch["samples"][name] = sample
+        return batch
+
+    async def batches(self, count=None):
+        '''!
+          @brief Yield one batch per period, on a fixed schedule that does not drift with the read time
+          @param count Number of batches, None for no limit
+          @return Asynchronous generator of batches, see read_batch()
+        '''
+        loop = asyncio.get_running_loop()
+        deadline = loop.time()
+        n = 0
+        while count is None or n < count:
+            yield await self.read_batch()
+            n += 1
+            deadline += self.period
+            delay = deadline - loop.time()
+            if delay > 0:
+                await asyncio.sleep(delay)
+            else:
+                deadline = loop.time()   # Overran, restart the schedule instead of bursting to catch up
@@ -0,0 +1,54 @@
+# -*- coding: utf-8 -*
+'''!
+  @file  gateway_poll.py
+  @brief  Read several sensors concurrently with the asyncio gateway poller
+  @details  Each sensor is read with one burst per sample and without per-read sleeps, the readings
+  @n        of all sensors arrive together as one timestamped batch. Requires Python 3.7 or later.
+  @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license  The MIT License (MIT)
+  @author  [qsjhyy](yihuan.huang@dfrobot.com)
+  @version  V1.0
+  @date  2021-10-28
+  @url  https://github.com/DFRobot/DFRobot_ENS160
+'''
+from __future__ import print_function
+import sys
+import os
+import asyncio
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+
+from DFRobot_ENS160 import *
+from DFRobot_ENS160_Gateway import DFRobot_ENS160_Gateway
+
+'''
+  # Two sensors on I2C bus 1 (SDO to GND: 0x52, SDO to VCC: 0x53) and one on SPI.
+  # Remove the ones you do not have.
+'''
+sensors = {
+  "room": DFRobot_ENS160_I2C(i2c_addr = 0x52, bus = 1),
+  "hall": DFRobot_ENS160_I2C(i2c_addr = 0x53, bus = 1),
+  # "lab": DFRobot_ENS160_SPI(cs=8, bus=0, dev=0, speed=2000000),
+}
+
+
+async def main():
+  for name, sensor in sensors.items():
+    sensor.set_fast_mode(True)
+    while (sensor.begin() == False):
+      print ('Please check that the device %s is properly connected' %name)
+      await asyncio.sleep(3)
+    sensor.set_temp_and_hum(ambient_temp=25.00, relative_humidity=50.00)
+  print("sensors begin successfully!!!")
+
+  gateway = DFRobot_ENS160_Gateway(sensors, period=1.0)
+  async for batch in gateway.batches():
+    for name, sample in sorted(batch["samples"].items()):
+      print("%.3f %s : status %u, AQI %u, TVOC %u ppb, eCO2 %u ppm"
+            %(sample["timestamp"], name, sample["validity_flag"], sample["AQI"], sample["TVOC"], sample["ECO2"]))
+    for name, error in batch["errors"].items():
+      print("%s : %s" %(name, error))
+    print()
+
+
+if __name__ == "__main__":
+  asyncio.run(main())
@@ -0,0 +1,63 @@
+# -*- coding: utf-8 -*
+'''!
+  @file  test_codec.py
+  @brief  Decode the blocks written by the C++ DFRobot_ENS160_Encoder with decode_block()
+  @details  ENS160_TEST_CODEC is the test_codec program of the Linux build, its --dump output holds the
+  @n        blocks and the samples encoded in them. CTest sets it; without it the tests are skipped.
+  @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license  The MIT License (MIT)
+  @author  [qsjhyy](yihuan.huang@dfrobot.com)
+  @version  V1.0
+  @date  2021-10-28
+  @url  https://github.com/DFRobot/DFRobot_ENS160
+'''
+import sys
+import os
+import json
+import subprocess
+import unittest
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+
+from DFRobot_ENS160_Codec import decode_block, ENS160_CODEC_TEMP_HUM
+
+TEST_CODEC = os.environ.get("ENS160_TEST_CODEC")
+
+
+@unittest.skipUnless(TEST_CODEC, "ENS160_TEST_CODEC not set")
+class TestCodecRoundTrip(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        out = subprocess.check_output([TEST_CODEC, "--dump"]).decode()
+        cls.cases = [json.loads(line) for line in out.splitlines() if line]
+
+    def test_cases(self):
+        self.assertEqual(len(self.cases), 3)
+
+    def test_decode(self):
+        for case in self.cases:
+            samples = decode_block(bytes.fromhex(case["block"]))
+            self.assertEqual(len(samples), len(case["samples"]))
+            for got, want in zip(samples, case["samples"]):
+                timestamp, status, aqi, tvoc, eco2, temp, hum = want
+                self.assertEqual(got["timestamp"], timestamp)
+                self.assertEqual(got["status"], status)
+                self.assertEqual(got["AQI"], aqi)
+                self.assertEqual(got["TVOC"], tvoc)
+                self.assertEqual(got["ECO2"], eco2)
+                if case["flags"] & ENS160_CODEC_TEMP_HUM:
+                    self.assertAlmostEqual(got["temp"], temp / 100.0)
+                    self.assertAlmostEqual(got["hum"], hum / 100.0)
+                else:
+                    self.assertNotIn("temp", got)
+
+    def test_truncated(self):
+        block = bytes.fromhex(self.cases[0]["block"])
+        with self.assertRaises(ValueError):
+            decode_block(block[:-1])
+        with self.assertRaises(ValueError):
+            decode_block(b"\x00" + block[1:])
+
+
+if __name__ == "__main__":
+    unittest.main()
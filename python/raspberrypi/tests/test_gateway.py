@@ -0,0 +1,235 @@
+# -*- coding: utf-8 -*
+'''!
+  @file  test_gateway.py
+  @brief  Unit tests of read_sample() and DFRobot_ENS160_Gateway on fake smbus, spidev and GPIO modules
+  @details  Run from python/raspberrypi: python3 -m unittest discover -s tests
+  @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+  @license  The MIT License (MIT)
+  @author  [qsjhyy](yihuan.huang@dfrobot.com)
+  @version  V1.0
+  @date  2021-10-28
+  @url  https://github.com/DFRobot/DFRobot_ENS160
+'''
+import sys
+import os
+import time
+import asyncio
+import threading
+import unittest
+sys.path.append(os.path.dirname(os.path.dirname(os.path.realpath(__file__))))
+
+import DFRobot_ENS160 as ens160
+from DFRobot_ENS160 import DFRobot_ENS160_I2C, DFRobot_ENS160_SPI, ENS160_DATA_STATUS_REG
+from DFRobot_ENS160_Gateway import DFRobot_ENS160_Gateway, _bus_of
+
+# DATA_STATUS..DATA_ECO2: STATAS, warm-up, NEWDAT; AQI 3; TVOC 0x1234; eCO2 0x0456
+SAMPLE = [0x80 | (1 << 2) | 0x02, 3, 0x34, 0x12, 0x56, 0x04]
+
+
+class FakeRegisters(object):
+    '''!
+      @brief Register file of one fake ENS160, counts the reads that overlap in time on its bus
+    '''
+    lock = threading.Lock()
+    active = {}   # bus key: reads in progress
+    overlaps = 0
+
+    def __init__(self, bus_key, short=False):
+        self.regs = [0] * 0x50
+        self.regs[ENS160_DATA_STATUS_REG:ENS160_DATA_STATUS_REG + len(SAMPLE)] = SAMPLE
+        self.bus_key = bus_key
+        self.short = short
+        self.reads = []
+
+    def read(self, reg, length):
+        with FakeRegisters.lock:
+            FakeRegisters.active[self.bus_key] = FakeRegisters.active.get(self.bus_key, 0) + 1
+            if FakeRegisters.active[self.bus_key] > 1:
+                FakeRegisters.overlaps += 1
+        time.sleep(0.005)   # Bus time, long enough for parallel reads to overlap
+        with FakeRegisters.lock:
+            FakeRegisters.active[self.bus_key] -= 1
+        self.reads.append((reg, length))
+        if self.short:
+            length -= 1
+        return self.regs[reg:reg + length]
+
+
+class FakeSMBus(object):
+    '''!
+      @brief The smbus methods the driver uses, one device per address
+    '''
+
+    def __init__(self, bus=1):
+        self.bus = bus
+        self.devices = {}
+
+    def write_i2c_block_data(self, addr, reg, data):
+        self.devices[addr].regs[reg:reg + len(data)] = data
+
+    def read_i2c_block_data(self, addr, reg, length):
+        return self.devices[addr].read(reg, length)
+
+
+class FakeGPIO(object):
+    '''!
+      @brief RPi.GPIO with the chip select levels recorded
+    '''
+    BCM = 11
+    OUT = 0
+    LOW = 0
+    HIGH = 1
+    levels = {}
+
+    @staticmethod
+    def setmode(mode):
+        pass
+
+    @staticmethod
+    def setwarnings(flag):
+        pass
+
+    @staticmethod
+    def setup(pin, mode, initial=1):
+        FakeGPIO.levels[pin] = initial
+
+    @staticmethod
+    def output(pin, level):
+        FakeGPIO.levels[pin] = level
+
+
+class FakeSpiDev(object):
+    '''!
+      @brief spidev.SpiDev on one register file per bus number
+    '''
+    devices = {}
+
+    def open(self, bus, dev):
+        self.bus = bus
+        self.dev = dev
+
+    def xfer2(self, data):
+        regs = FakeSpiDev.devices[(self.bus, self.dev)]
+        reg = data[0] >> 1
+        if data[0] & 0x01:
+            return [0] + regs.read(reg, len(data) - 1)
+        regs.regs[reg:reg + len(data) - 1] = data[1:]
+        return [0] * len(data)
+
+
+class FakeSpidevModule(object):
+    SpiDev = FakeSpiDev
+
+
+class TestReadSample(unittest.TestCase):
+
+    def setUp(self):
+        ens160.GPIO = FakeGPIO
+        ens160.spidev = FakeSpidevModule
+
+    def test_i2c_decoding(self):
+        bus = FakeSMBus()
+        bus.devices[0x53] = FakeRegisters("i2c")
+        sensor = DFRobot_ENS160_I2C(i2c_addr=0x53, bus=bus)
+        sensor.set_fast_mode(True)
+        sample = sensor.read_sample()
+        self.assertEqual(bus.devices[0x53].reads, [(ENS160_DATA_STATUS_REG, 6)])   # One burst
+        self.assertEqual(sample["status"], SAMPLE[0])
+        self.assertEqual(sample["validity_flag"], 1)
+        self.assertEqual(sample["new_data"], 1)
+        self.assertEqual(sample["AQI"], 3)
+        self.assertEqual(sample["TVOC"], 0x1234)
+        self.assertEqual(sample["ECO2"], 0x0456)
+        self.assertAlmostEqual(sample["timestamp"], time.time(), delta=1.0)
+
+    def test_short_read(self):
+        bus = FakeSMBus()
+        bus.devices[0x52] = FakeRegisters("i2c", short=True)
+        sensor = DFRobot_ENS160_I2C(i2c_addr=0x52, bus=bus)
+        with self.assertRaises(IOError):
+            sensor.read_sample()
+
+    def test_spi_decoding(self):
+        FakeSpiDev.devices[(0, 0)] = FakeRegisters("spi")
+        sensor = DFRobot_ENS160_SPI(cs=8, bus=0, dev=0)
+        sensor.set_fast_mode(True)
+        sample = sensor.read_sample()
+        self.assertEqual(FakeSpiDev.devices[(0, 0)].reads, [(ENS160_DATA_STATUS_REG, 6)])
+        self.assertEqual(FakeGPIO.levels[8], FakeGPIO.HIGH)   # Released after the burst
+        self.assertEqual(sample["TVOC"], 0x1234)
+        self.assertEqual(sample["ECO2"], 0x0456)
+
+
+class TestGateway(unittest.TestCase):
+
+    def setUp(self):
+        ens160.GPIO = FakeGPIO
+        ens160.spidev = FakeSpidevModule
+        FakeRegisters.active = {}
+        FakeRegisters.overlaps = 0
+
+    def test_bus_grouping(self):
+        i2c1 = FakeSMBus(1)
+        i2c1.devices[0x52] = FakeRegisters(("i2c", 1))
+        i2c1.devices[0x53] = FakeRegisters(("i2c", 1))
+        for dev in (0, 1):
+            FakeSpiDev.devices[(0, dev)] = FakeRegisters(("spi", 0))
+        FakeSpiDev.devices[(1, 0)] = FakeRegisters(("spi", 1))
+        sensors = {
+            "a": DFRobot_ENS160_I2C(i2c_addr=0x52, bus=i2c1),
+            "b": DFRobot_ENS160_I2C(i2c_addr=0x53, bus=i2c1),
+            "c": DFRobot_ENS160_SPI(cs=8, bus=0, dev=0),
+            "d": DFRobot_ENS160_SPI(cs=7, bus=0, dev=0),   # Same controller, other GPIO chip select
+            "e": DFRobot_ENS160_SPI(cs=None, bus=0, dev=1),   # Same controller, CE1
+            "f": DFRobot_ENS160_SPI(cs=None, bus=1, dev=0),
+        }
+        self.assertEqual(_bus_of(sensors["c"]), ("spi", 0))
+        self.assertEqual(_bus_of(sensors["c"]), _bus_of(sensors["d"]))
+        self.assertEqual(_bus_of(sensors["c"]), _bus_of(sensors["e"]))
+        self.assertNotEqual(_bus_of(sensors["c"]), _bus_of(sensors["f"]))
+
+        gateway = DFRobot_ENS160_Gateway(sensors)
+        groups = sorted(sorted(name for name, sensor in group) for group in gateway._groups.values())
+        self.assertEqual(groups, [["a", "b"], ["c", "d", "e"], ["f"]])
+        batch = asyncio.run(gateway.read_batch())
+        self.assertEqual(sorted(batch["samples"]), ["a", "b", "c", "d", "e", "f"])
+        self.assertEqual(FakeRegisters.overlaps, 0)   # Never two reads at once on one bus
+
+    def test_explicit_bus_key(self):
+        wires = FakeRegisters(("spi", 0))
+        FakeSpiDev.devices[(0, 0)] = wires
+        first = FakeSpiDev()
+        first.open(0, 0)
+        second = FakeSpiDev()
+        second.open(0, 0)
+        sensors = [DFRobot_ENS160_SPI(cs=None, spi=first), DFRobot_ENS160_SPI(cs=None, spi=second)]
+        self.assertNotEqual(_bus_of(sensors[0]), _bus_of(sensors[1]))   # Injected objects: by identity
+        for sensor in sensors:
+            sensor.bus_key = ("spi", 0)
+        gateway = DFRobot_ENS160_Gateway(sensors)
+        self.assertEqual(len(gateway._groups), 1)
+
+    def test_error_batching(self):
+        bus = FakeSMBus()
+        bus.devices[0x52] = FakeRegisters(("i2c", 1))
+        bus.devices[0x53] = FakeRegisters(("i2c", 1), short=True)
+        sensors = {"good": DFRobot_ENS160_I2C(0x52, bus), "bad": DFRobot_ENS160_I2C(0x53, bus)}
+        gateway = DFRobot_ENS160_Gateway(sensors, period=0.01)
+
+        async def collect():
+            return [batch async for batch in gateway.batches(count=3)]
+
+        start = time.time()
+        batches = asyncio.run(collect())
+        self.assertEqual(len(batches), 3)
+        for batch in batches:
+            self.assertGreaterEqual(batch["timestamp"], start)
+            self.assertEqual(list(batch["samples"]), ["good"])
+            self.assertEqual(list(batch["errors"]), ["bad"])   # The failure does not stop the others
+            self.assertIsInstance(batch["errors"]["bad"], IOError)
+            self.assertEqual(batch["samples"]["good"]["AQI"], 3)
+        self.assertLess(batches[0]["timestamp"], batches[-1]["timestamp"])
+
+
+if __name__ == "__main__":
+    unittest.main()